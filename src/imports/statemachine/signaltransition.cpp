@@ -175,7 +175,7 @@ void SignalTransition::connectTriggered()
     QMetaMethod metaMethod = target->metaObject()->method(qobjectSignal->methodIndex());
     int signalIndex = QMetaObjectPrivate::signalIndex(metaMethod);
 
-    auto f = m_compilationUnit->runtimeFunctions[binding->value.compiledScriptIndex];
+    auto f = m_compilationUnit->runtimeFunctionAt(binding->value.compiledScriptIndex);
     if (ctxtdata) {
         QQmlBoundSignalExpression *expression =
                 new QQmlBoundSignalExpression(target, signalIndex, ctxtdata, this, f);
@@ -75,7 +75,7 @@ QT_BEGIN_NAMESPACE
 // Also change the comment behind the number to describe the latest change. This has the added
 // benefit that if another patch changes the version too, it will result in a merge conflict, and
 // not get removed silently.
-#define QV4_DATA_STRUCTURE_VERSION 0x29// support additional required property features
+#define QV4_DATA_STRUCTURE_VERSION 0x2A// record the shape of comparison functions
 
 class QIODevice;
 class QQmlTypeNameCache;
@@ -287,7 +287,19 @@ struct Function
     enum Flags : unsigned int {
         IsStrict            = 0x1,
         IsArrowFunction     = 0x2,
-        IsGenerator         = 0x4
+        IsGenerator         = 0x4,
+        IgnoresArguments    = 0x8  // neither the parameters nor the arguments object are read
+    };
+
+    // Comparison functions whose result sort() can compute without calling them.
+    // The compared values are either the arguments or, if comparatorKeyIndex is
+    // valid, the property of that name of the arguments.
+    enum Comparator : quint8 {
+        NoComparator,
+        NumericAscending,   // (a, b) => a - b
+        NumericDescending,  // (a, b) => b - a
+        LessThanAscending,  // (a, b) => a < b ? -1 : 1
+        LessThanDescending  // (a, b) => a > b ? -1 : 1
     };
 
     // Absolute offset into file where the code for this function is located.
@@ -308,6 +320,7 @@ struct Function
     quint32_le nRegisters;
     Location location;
     quint32_le nLabelInfos;
+    quint32_le comparatorKeyIndex;
 
     quint16_le sizeOfLocalTemporalDeadZone;
     quint16_le firstTemporalDeadZoneRegister;
@@ -317,7 +330,7 @@ struct Function
 
     // Keep all unaligned data at the end
     quint8 flags;
-    quint8 padding1;
+    quint8 comparator;
 
     //    quint32 formalsIndex[nFormals]
     //    quint32 localsIndex[nLocals]
@@ -347,7 +360,7 @@ struct Function
         return (a + 7) & ~size_t(7);
     }
 };
-static_assert(sizeof(Function) == 56, "Function structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
+static_assert(sizeof(Function) == 60, "Function structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
 
 struct Method {
     enum Type {
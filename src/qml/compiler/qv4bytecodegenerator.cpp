@@ -41,6 +41,8 @@
 #include <private/qv4compilercontext_p.h>
 #include <private/qqmljsastfwd_p.h>
 
+#include <algorithm>
+
 QT_USE_NAMESPACE
 using namespace QV4;
 using namespace Moth;
@@ -186,6 +188,24 @@ void BytecodeGenerator::finalize(Compiler::Context *context)
     }
 }
 
+// Instructions that only set the accumulator, without reading it or having side effects
+static bool isPureAccumulatorLoad(int type)
+{
+    switch (type) {
+    case int(Instr::Type::LoadConst):
+    case int(Instr::Type::LoadZero):
+    case int(Instr::Type::LoadTrue):
+    case int(Instr::Type::LoadFalse):
+    case int(Instr::Type::LoadNull):
+    case int(Instr::Type::LoadUndefined):
+    case int(Instr::Type::LoadInt):
+    case int(Instr::Type::LoadReg):
+        return true;
+    default:
+        return false;
+    }
+}
+
 int BytecodeGenerator::addInstructionHelper(Instr::Type type, const Instr &i, int offsetOfOffset) {
     if (lastInstrType == int(Instr::Type::StoreReg)) {
         if (type == Instr::Type::LoadReg) {
@@ -202,6 +222,35 @@ int BytecodeGenerator::addInstructionHelper(Instr::Type type, const Instr &i, in
                 return -1;
             }
         }
+        if (type == Instr::Type::StoreReg) {
+            if (i.StoreReg.reg == lastInstr.StoreReg.reg) {
+                // value is already in the register
+                return -1;
+            }
+        }
+    }
+    if (lastInstrType == int(Instr::Type::LoadReg)) {
+        if (type == Instr::Type::StoreReg) {
+            if (i.StoreReg.reg == lastInstr.LoadReg.reg) {
+                // value is already in the register
+                return -1;
+            }
+        }
+    }
+    if (isPureAccumulatorLoad(lastInstrType) && isPureAccumulatorLoad(int(type))) {
+        const int argCount = Moth::InstrInfo::argumentCount[static_cast<int>(type)];
+        if (lastInstrType == int(type)
+                && std::equal(i.argumentsAsInts, i.argumentsAsInts + argCount,
+                              lastInstr.argumentsAsInts)) {
+            // same value is already in the accumulator
+            return -1;
+        }
+        if (!debugMode) {
+            // The previous load is overwritten before being used. Labels linked after it reset
+            // lastInstrType, and labels pointing at it will point at this load instead.
+            Q_ASSERT(!instructions.isEmpty() && instructions.constLast().offsetForJump == -1);
+            instructions.removeLast();
+        }
     }
     lastInstrType = int(type);
     lastInstr = i;
@@ -1521,7 +1521,10 @@ bool Codegen::visit(BinaryExpression *ast)
             visit(rhs);
             right = exprResult();
         } else {
-            left = left.storeOnStack(); // force any loads of the lhs, so the rhs won't clobber it
+            // force any loads of the lhs, so the rhs won't clobber it. Constants can't be
+            // clobbered, and keeping them allows folding.
+            if (!left.isConstant())
+                left = left.storeOnStack();
             right = expression(ast->right);
         }
         if (hasError())
@@ -1539,8 +1542,56 @@ bool Codegen::visit(BinaryExpression *ast)
     return false;
 }
 
+// Evaluates arithmetic on two numeric constants at compile time. The results have to match
+// what the corresponding runtime functions would calculate.
+static bool foldNumericBinop(QSOperator::Op oper, StaticValue left, StaticValue right,
+                             ReturnedValue *result)
+{
+    if (!left.isNumber() || !right.isNumber())
+        return false;
+
+    const double a = left.asDouble();
+    const double b = right.asDouble();
+    switch (oper) {
+    case QSOperator::Add:
+        *result = Encode::smallestNumber(a + b);
+        return true;
+    case QSOperator::Sub:
+        *result = Encode::smallestNumber(a - b);
+        return true;
+    case QSOperator::Mul:
+        *result = Encode::smallestNumber(a * b);
+        return true;
+    case QSOperator::Div:
+        *result = Encode::smallestNumber(a / b);
+        return true;
+    case QSOperator::Mod:
+        *result = Encode::smallestNumber(std::fmod(a, b));
+        return true;
+    case QSOperator::LShift:
+        *result = Encode(int(uint(left.toInt32()) << (right.toInt32() & 0x1f)));
+        return true;
+    case QSOperator::RShift:
+        *result = Encode(left.toInt32() >> (right.toInt32() & 0x1f));
+        return true;
+    case QSOperator::URShift:
+        *result = Encode::smallestNumber(double(uint(left.toInt32()) >> (right.toInt32() & 0x1f)));
+        return true;
+    default:
+        return false;
+    }
+}
+
 Codegen::Reference Codegen::binopHelper(QSOperator::Op oper, Reference &left, Reference &right)
 {
+    if (left.isConstant() && right.isConstant()) {
+        ReturnedValue result;
+        if (foldNumericBinop(oper, StaticValue::fromReturnedValue(left.constant),
+                             StaticValue::fromReturnedValue(right.constant), &result)) {
+            return Reference::fromConst(this, result);
+        }
+    }
+
     switch (oper) {
     case QSOperator::Add: {
         left = left.storeOnStack();
@@ -1657,6 +1708,7 @@ Codegen::Reference Codegen::binopHelper(QSOperator::Op oper, Reference &left, Re
             ushr.rhs = StaticValue::fromReturnedValue(right.constant).toInt32() & 0x1f;
             bytecodeGenerator->addInstruction(ushr);
         } else {
+            left = left.storeOnStack();
             right.loadInAccumulator();
             Instruction::UShr ushr;
             ushr.lhs = left.stackSlot();
@@ -1670,6 +1722,7 @@ Codegen::Reference Codegen::binopHelper(QSOperator::Op oper, Reference &left, Re
             shr.rhs = StaticValue::fromReturnedValue(right.constant).toInt32() & 0x1f;
             bytecodeGenerator->addInstruction(shr);
         } else {
+            left = left.storeOnStack();
             right.loadInAccumulator();
             Instruction::Shr shr;
             shr.lhs = left.stackSlot();
@@ -1683,6 +1736,7 @@ Codegen::Reference Codegen::binopHelper(QSOperator::Op oper, Reference &left, Re
             shl.rhs = StaticValue::fromReturnedValue(right.constant).toInt32() & 0x1f;
             bytecodeGenerator->addInstruction(shl);
         } else {
+            left = left.storeOnStack();
             right.loadInAccumulator();
             Instruction::Shl shl;
             shl.lhs = left.stackSlot();
@@ -3015,6 +3069,162 @@ static bool endsWithReturn(Module *module, Node *node)
     return false;
 }
 
+static ExpressionNode *stripParentheses(ExpressionNode *expression)
+{
+    while (NestedExpression *nested = AST::cast<NestedExpression *>(expression))
+        expression = nested->expression;
+    return expression;
+}
+
+// Returns which of the parameters \a a and \a b the \a expression reads, either
+// directly or as a member whose name is stored in \a key, or -1 for anything else.
+static int comparedParameter(ExpressionNode *expression, const QStringRef &a, const QStringRef &b,
+                             QStringRef *key)
+{
+    expression = stripParentheses(expression);
+    *key = QStringRef();
+    if (FieldMemberExpression *member = AST::cast<FieldMemberExpression *>(expression)) {
+        *key = member->name;
+        expression = member->base;
+    }
+    IdentifierExpression *identifier = AST::cast<IdentifierExpression *>(expression);
+    if (!identifier)
+        return -1;
+    if (identifier->name == a)
+        return 0;
+    if (identifier->name == b)
+        return 1;
+    return -1;
+}
+
+static bool comparesParameters(BinaryExpression *binary, const QStringRef &a, const QStringRef &b,
+                               QStringRef *key, bool *swapped)
+{
+    QStringRef rightKey;
+    const int left = comparedParameter(binary->left, a, b, key);
+    const int right = comparedParameter(binary->right, a, b, &rightKey);
+    if (left < 0 || right < 0 || left == right || *key != rightKey)
+        return false;
+    *swapped = left == 1;
+    return true;
+}
+
+static bool isNegativeConstant(ExpressionNode *expression)
+{
+    expression = stripParentheses(expression);
+    if (NumericLiteral *literal = AST::cast<NumericLiteral *>(expression))
+        return literal->value < 0;
+    if (UnaryMinusExpression *minus = AST::cast<UnaryMinusExpression *>(expression)) {
+        NumericLiteral *literal = AST::cast<NumericLiteral *>(stripParentheses(minus->expression));
+        return literal && literal->value > 0;
+    }
+    return false;
+}
+
+// Whether \a expression is a non-negative constant, or picks one depending on
+// another comparison of the same values.
+static bool isNonNegativeConstant(ExpressionNode *expression, const QStringRef &a,
+                                  const QStringRef &b, const QStringRef &key)
+{
+    expression = stripParentheses(expression);
+    if (NumericLiteral *literal = AST::cast<NumericLiteral *>(expression))
+        return literal->value >= 0;
+    ConditionalExpression *conditional = AST::cast<ConditionalExpression *>(expression);
+    if (!conditional)
+        return false;
+    BinaryExpression *condition = AST::cast<BinaryExpression *>(stripParentheses(conditional->expression));
+    if (!condition)
+        return false;
+    switch (condition->op) {
+    case QSOperator::Lt: case QSOperator::Gt: case QSOperator::Le: case QSOperator::Ge:
+    case QSOperator::Equal: case QSOperator::NotEqual:
+    case QSOperator::StrictEqual: case QSOperator::StrictNotEqual:
+        break;
+    default:
+        return false;
+    }
+    QStringRef conditionKey;
+    bool swapped;
+    return comparesParameters(condition, a, b, &conditionKey, &swapped) && conditionKey == key
+            && isNonNegativeConstant(conditional->ok, a, b, key)
+            && isNonNegativeConstant(conditional->ko, a, b, key);
+}
+
+static bool readsName(const Context *context, const QString &name)
+{
+    if (context->hasDirectEval || context->usedVariables.contains(name))
+        return true;
+    for (const Context *nested : context->nestedContexts) {
+        if (readsName(nested, name))
+            return true;
+    }
+    return false;
+}
+
+// Signal handlers often don't look at the signal's arguments at all. Callers can
+// then skip converting them, as the function behaves the same without them.
+static bool ignoresArguments(const Context *context, FormalParameterList *formals, bool debugMode)
+{
+    if (debugMode || context->usesArgumentsObject == Context::ArgumentsObjectUsed)
+        return false;
+    if (formals && !formals->isSimpleParameterList())
+        return false;
+    for (const auto &argument : context->arguments) {
+        if (readsName(context, argument.id))
+            return false;
+    }
+    return !context->hasDirectEval;
+}
+
+// Recognizes the usual ways of writing a comparison function for sort(), see
+// CompiledData::Function::Comparator.
+static CompiledData::Function::Comparator comparatorShape(FormalParameterList *formals,
+                                                          StatementList *body, QString *key)
+{
+    using Function = CompiledData::Function;
+
+    if (!formals || !formals->isSimpleParameterList() || !formals->next || formals->next->next)
+        return Function::NoComparator;
+    if (!formals->element || !formals->next->element)
+        return Function::NoComparator;
+    const QStringRef a = formals->element->bindingIdentifier;
+    const QStringRef b = formals->next->element->bindingIdentifier;
+    if (a.isEmpty() || b.isEmpty() || a == b)
+        return Function::NoComparator;
+
+    if (!body || body->next)
+        return Function::NoComparator;
+    ReturnStatement *returnStatement = AST::cast<ReturnStatement *>(body->statement);
+    if (!returnStatement || !returnStatement->expression)
+        return Function::NoComparator;
+
+    ExpressionNode *result = stripParentheses(returnStatement->expression);
+    QStringRef resultKey;
+    bool swapped;
+    if (BinaryExpression *difference = AST::cast<BinaryExpression *>(result)) {
+        if (difference->op != QSOperator::Sub
+                || !comparesParameters(difference, a, b, &resultKey, &swapped)) {
+            return Function::NoComparator;
+        }
+        *key = resultKey.toString();
+        return swapped ? Function::NumericDescending : Function::NumericAscending;
+    }
+
+    ConditionalExpression *conditional = AST::cast<ConditionalExpression *>(result);
+    if (!conditional)
+        return Function::NoComparator;
+    BinaryExpression *condition = AST::cast<BinaryExpression *>(stripParentheses(conditional->expression));
+    if (!condition || (condition->op != QSOperator::Lt && condition->op != QSOperator::Gt)
+            || !comparesParameters(condition, a, b, &resultKey, &swapped)
+            || !isNegativeConstant(conditional->ok)
+            || !isNonNegativeConstant(conditional->ko, a, b, resultKey)) {
+        return Function::NoComparator;
+    }
+    *key = resultKey.toString();
+    return ((condition->op == QSOperator::Lt) != swapped) ? Function::LessThanAscending
+                                                           : Function::LessThanDescending;
+}
+
 int Codegen::defineFunction(const QString &name, AST::Node *ast,
                             AST::FormalParameterList *formals,
                             AST::StatementList *body)
@@ -3048,6 +3258,9 @@ int Codegen::defineFunction(const QString &name, AST::Node *ast,
     // that the binding is a function, so we should execute that. However, we don't know that during
     // AOT compilation, so mark the surrounding function as only-returning-a-closure.
     _context->returnsClosure = body && body->statement && cast<ExpressionStatement *>(body->statement) && cast<FunctionExpression *>(cast<ExpressionStatement *>(body->statement)->expression);
+    if (!_context->isGenerator)
+        _context->comparator = comparatorShape(formals, body, &_context->comparatorKey);
+    _context->ignoresArguments = ignoresArguments(_context, formals, _module->debugMode);
 
     BytecodeGenerator bytecode(_context->line, _module->debugMode);
     BytecodeGenerator *savedBytecodeGenerator;
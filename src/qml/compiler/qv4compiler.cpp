@@ -270,6 +270,7 @@ QV4::CompiledData::Unit *QV4::Compiler::JSUnitGenerator::generateUnit(GeneratorO
     for (Context *f : qAsConst(module->functions)) {
         registerString(f->name);
         registerString(f->returnType);
+        registerString(f->comparatorKey);
         for (int i = 0; i < f->arguments.size(); ++i) {
             registerString(f->arguments.at(i).id);
             registerString(f->arguments.at(i).typeName());
@@ -438,9 +439,14 @@ void QV4::Compiler::JSUnitGenerator::writeFunction(char *f, QV4::Compiler::Conte
         function->flags |= CompiledData::Function::IsArrowFunction;
     if (irFunction->isGenerator)
         function->flags |= CompiledData::Function::IsGenerator;
+    if (irFunction->ignoresArguments)
+        function->flags |= CompiledData::Function::IgnoresArguments;
     function->nestedFunctionIndex =
             irFunction->returnsClosure ? quint32(module->functions.indexOf(irFunction->nestedContexts.first()))
                                        : std::numeric_limits<uint32_t>::max();
+    function->comparator = irFunction->comparator;
+    function->comparatorKeyIndex = irFunction->comparatorKey.isEmpty()
+            ? std::numeric_limits<uint32_t>::max() : quint32(getStringId(irFunction->comparatorKey));
     function->length = irFunction->formals ? irFunction->formals->length() : 0;
     function->nFormals = irFunction->arguments.size();
     function->formalsOffset = currentOffset;
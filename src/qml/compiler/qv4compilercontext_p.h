@@ -222,6 +222,9 @@ struct Context {
     bool innerFunctionAccessesThis = false;
     bool innerFunctionAccessesNewTarget = false;
     bool returnsClosure = false;
+    bool ignoresArguments = false;
+    CompiledData::Function::Comparator comparator = CompiledData::Function::NoComparator;
+    QString comparatorKey;
     mutable bool argumentsCanEscape = false;
     bool requiresExecutionContext = false;
     bool isWithBlock = false;
@@ -44,6 +44,11 @@
 #include "qv4argumentsobject_p.h"
 #include "qv4string_p.h"
 #include "qv4jscall_p.h"
+#include "qv4function_p.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 using namespace QV4;
 
@@ -627,102 +632,231 @@ void ArrayData::insert(Object *o, uint index, const Value *v, bool isAccessor)
 class ArrayElementLessThan
 {
 public:
-    inline ArrayElementLessThan(ExecutionEngine *engine, const Value &comparefn)
+    inline ArrayElementLessThan(ExecutionEngine *engine, const FunctionObject &comparefn)
         : m_engine(engine), m_comparefn(comparefn) {}
 
     bool operator()(Value v1, Value v2) const;
 
 private:
     ExecutionEngine *m_engine;
-    const Value &m_comparefn;
+    const FunctionObject &m_comparefn;
 };
 
 
 bool ArrayElementLessThan::operator()(Value v1, Value v2) const
 {
-    Scope scope(m_engine);
-
-    if (v1.isUndefined() || v1.isEmpty())
+    // Once the comparison function threw, the sort only needs to finish
+    if (m_engine->hasException)
         return false;
-    if (v2.isUndefined() || v2.isEmpty())
-        return true;
-    ScopedFunctionObject o(scope, m_comparefn);
-    if (o) {
-        Scope scope(o->engine());
-        ScopedValue result(scope);
-        JSCallData jsCallData(scope, 2);
-        jsCallData->args[0] = v1;
-        jsCallData->args[1] = v2;
-        result = o->call(jsCallData);
-        if (scope.hasException())
-            return false;
 
-        return result->toNumber() < 0;
-    }
-    ScopedString p1s(scope, v1.toString(scope.engine));
-    ScopedString p2s(scope, v2.toString(scope.engine));
-
-    if (!p1s)
+    Scope scope(m_engine);
+    ScopedValue result(scope);
+    JSCallData jsCallData(scope, 2);
+    jsCallData->args[0] = v1;
+    jsCallData->args[1] = v2;
+    result = m_comparefn.call(jsCallData);
+    if (scope.hasException())
         return false;
-    if (!p2s)
-        return true;
 
-    return p1s->toQString() < p2s->toQString();
+    return result->toNumber() < 0;
 }
 
-template <typename RandomAccessIterator, typename T, typename LessThan>
-void sortHelper(RandomAccessIterator start, RandomAccessIterator end, const T &t, LessThan lessThan)
+template <typename Key>
+struct SortKey
 {
-top:
-    int span = int(end - start);
-    if (span < 2)
-        return;
+    Key key;
+    uint index;
+};
 
-    --end;
-    RandomAccessIterator low = start, high = end - 1;
-    RandomAccessIterator pivot = start + span / 2;
+template <typename Key>
+struct SortKeyLessThan
+{
+    bool descending;
 
-    if (lessThan(*end, *start))
-        qSwap(*end, *start);
-    if (span == 2)
-        return;
+    bool operator()(const SortKey<Key> &a, const SortKey<Key> &b) const
+    {
+        return descending ? b.key < a.key : a.key < b.key;
+    }
+};
 
-    if (lessThan(*pivot, *start))
-        qSwap(*pivot, *start);
-    if (lessThan(*end, *pivot))
-        qSwap(*end, *pivot);
-    if (span == 3)
+// Merges the sorted ranges [begin, middle) and [middle, end) of values.
+template <typename T, typename LessThan>
+static void mergeRuns(T *values, T *buffer, uint begin, uint middle, uint end, const LessThan &lessThan)
+{
+    if (!lessThan(values[middle], values[middle - 1]))
         return;
 
-    qSwap(*pivot, *end);
+    std::copy(values + begin, values + middle, buffer);
+    T *left = buffer;
+    T *leftEnd = buffer + (middle - begin);
+    T *right = values + middle;
+    T *rightEnd = values + end;
+    T *out = values + begin;
+    while (left != leftEnd && right != rightEnd) {
+        if (lessThan(*right, *left))
+            *out++ = *right++;
+        else
+            *out++ = *left++;
+    }
+    std::copy(left, leftEnd, out);
+}
 
-    while (low < high) {
-        while (low < high && lessThan(*low, *end))
-            ++low;
+// A stable natural merge sort: it splits values into ascending runs (reversing
+// strictly descending ones), extends short runs by binary insertion and merges
+// neighbouring runs. Sorted or reverse sorted input takes a single pass.
+// Elements never leave values and buffer, so both can be visible to the GC.
+template <typename T, typename LessThan>
+static void adaptiveMergeSort(T *values, T *buffer, uint length, const LessThan &lessThan)
+{
+    const uint minRun = 16;
+
+    std::vector<uint> runs;
+    runs.push_back(0);
+    uint start = 0;
+    while (start < length) {
+        uint end = start + 1;
+        if (end < length) {
+            if (lessThan(values[end], values[start])) {
+                while (end + 1 < length && lessThan(values[end + 1], values[end]))
+                    ++end;
+                std::reverse(values + start, values + end + 1);
+            } else {
+                while (end + 1 < length && !lessThan(values[end + 1], values[end]))
+                    ++end;
+            }
+            ++end;
+        }
 
-        while (high > low && lessThan(*end, *high))
-            --high;
+        const uint minEnd = std::min(start + minRun, length);
+        for (; end < minEnd; ++end) {
+            uint low = start;
+            uint high = end;
+            while (low < high) {
+                const uint middle = low + (high - low) / 2;
+                if (lessThan(values[end], values[middle]))
+                    high = middle;
+                else
+                    low = middle + 1;
+            }
+            std::rotate(values + low, values + end, values + end + 1);
+        }
 
-        if (low < high) {
-            qSwap(*low, *high);
-            ++low;
-            --high;
-        } else {
-            break;
+        runs.push_back(end);
+        start = end;
+    }
+
+    while (runs.size() > 2) {
+        size_t next = 1;
+        for (size_t i = 0; i + 2 < runs.size(); i += 2) {
+            mergeRuns(values, buffer, runs[i], runs[i + 1], runs[i + 2], lessThan);
+            runs[next++] = runs[i + 2];
         }
+        if (runs.size() % 2 == 0)
+            runs[next++] = runs.back();
+        runs.resize(next);
     }
+}
 
-    if (lessThan(*low, *end))
-        ++low;
+// Returns room for length values, kept alive by holder.
+static Value *sortStorage(Scoped<ArrayObject> &holder, uint length)
+{
+    holder->arrayReserve(length);
+    Heap::SimpleArrayData *d = holder->d()->arrayData.cast<Heap::SimpleArrayData>();
+    for (uint i = 0; i < length; ++i)
+        d->values.values[i] = Value::undefinedValue();
+    d->values.size = length;
+    return d->values.values;
+}
 
-    qSwap(*end, *low);
-    sortHelper(start, low, t, lessThan);
+// Sorts values by the keys, and writes the result to sorted.
+template <typename Key>
+static void sortByKeys(std::vector<SortKey<Key>> &keys, bool descending, const Value *values, Value *sorted)
+{
+    std::vector<SortKey<Key>> buffer(keys.size());
+    adaptiveMergeSort(keys.data(), buffer.data(), uint(keys.size()), SortKeyLessThan<Key>{ descending });
+    for (size_t i = 0; i < keys.size(); ++i)
+        sorted[i] = values[keys[i].index];
+}
 
-    start = low + 1;
-    ++end;
-    goto top;
+// Stores what a comparison function of a recognized shape compares for value
+// in compared. Returns false if that isn't a primitive, or has side effects.
+static bool comparedValue(ExecutionEngine *engine, Heap::String *key, const Value &value, Value *compared)
+{
+    if (key) {
+        const Object *o = value.as<Object>();
+        if (!o)
+            return false;
+        Scope scope(engine);
+        ScopedString name(scope, key);
+        *compared = o->get(name);
+        if (engine->hasException)
+            return false;
+    } else {
+        *compared = value;
+    }
+    return compared->isPrimitive() && !compared->isSymbol();
 }
 
+// Sorts values without calling the comparison function, if it is of a shape we
+// recognize and the values it compares allow that.
+static bool sortByComparator(ExecutionEngine *engine, const FunctionObject *comparefn,
+                             Value *values, Value *sorted, uint length)
+{
+    using CompiledFunction = CompiledData::Function;
+
+    Function *function = comparefn->function();
+    if (!function || function->compiledFunction->comparator == CompiledFunction::NoComparator)
+        return false;
+
+    const quint32 keyIndex = function->compiledFunction->comparatorKeyIndex;
+    Heap::String *key = keyIndex == std::numeric_limits<uint32_t>::max()
+            ? nullptr : function->compilationUnit->runtimeStrings[keyIndex];
+
+    Scope scope(engine);
+    ScopedArrayObject comparedHolder(scope, engine->newArrayObject());
+    Value *compared = sortStorage(comparedHolder, length);
+    bool numbers = true;
+    bool strings = true;
+    for (uint i = 0; i < length; ++i) {
+        if (!comparedValue(engine, key, values[i], compared + i))
+            return false;
+        numbers &= compared[i].isNumber();
+        strings &= compared[i].isString();
+    }
+
+    bool descending = false;
+    switch (function->compiledFunction->comparator) {
+    case CompiledFunction::NumericDescending:
+        descending = true;
+        Q_FALLTHROUGH();
+    case CompiledFunction::NumericAscending:
+        numbers = true;
+        strings = false;
+        break;
+    case CompiledFunction::LessThanDescending:
+        descending = true;
+        break;
+    default:
+        break;
+    }
+
+    if (numbers) {
+        std::vector<SortKey<double>> keys(length);
+        for (uint i = 0; i < length; ++i)
+            keys[i] = { compared[i].toNumber(), i };
+        sortByKeys(keys, descending, values, sorted);
+    } else if (strings) {
+        std::vector<SortKey<QString>> keys(length);
+        for (uint i = 0; i < length; ++i)
+            keys[i] = { compared[i].toQString(), i };
+        sortByKeys(keys, descending, values, sorted);
+    } else {
+        return false;
+    }
+
+    std::copy(sorted, sorted + length, values);
+    return true;
+}
 
 void ArrayData::sort(ExecutionEngine *engine, Object *thisObject, const Value &comparefn, uint len)
 {
@@ -814,10 +948,56 @@ void ArrayData::sort(ExecutionEngine *engine, Object *thisObject, const Value &c
     }
 
 
-    ArrayElementLessThan lessThan(engine, static_cast<const FunctionObject &>(comparefn));
+    // Sort a copy, the comparison function or the conversion to strings may
+    // change the array. Undefined values go to the end without being compared.
+    ScopedArrayObject valuesHolder(scope, engine->newArrayObject());
+    ScopedArrayObject bufferHolder(scope, engine->newArrayObject());
+    Value *values = sortStorage(valuesHolder, len);
+    Value *buffer = sortStorage(bufferHolder, len);
+    uint defined = 0;
+    {
+        // The array data is sparse here if entries past len had to be kept
+        arrayData = thisObject->arrayData();
+        for (uint i = 0; i < len; ++i) {
+            const Value value = Value::fromReturnedValue(arrayData->get(i));
+            if (!value.isUndefined())
+                values[defined++] = value;
+        }
+    }
+
+    if (const FunctionObject *compare = comparefn.as<FunctionObject>()) {
+        if (!sortByComparator(engine, compare, values, buffer, defined) && !engine->hasException)
+            adaptiveMergeSort(values, buffer, defined, ArrayElementLessThan(engine, *compare));
+    } else {
+        // Compare the string values, each converted only once
+        std::vector<SortKey<QString>> keys(defined);
+        ScopedString string(scope);
+        for (uint i = 0; i < defined; ++i) {
+            string = values[i].toString(engine);
+            if (engine->hasException)
+                return;
+            keys[i] = { string->toQString(), i };
+        }
+        sortByKeys(keys, /*descending*/false, values, buffer);
+        std::copy(buffer, buffer + defined, values);
+    }
+
+    if (engine->hasException)
+        return;
 
-    Value *begin = thisObject->arrayData()->values.values;
-    sortHelper(begin, begin + len, *begin, lessThan);
+    arrayData = thisObject->arrayData();
+    if (!arrayData)
+        return;
+    if (arrayData->type() == Heap::ArrayData::Sparse) {
+        for (uint i = 0; i < len; ++i)
+            thisObject->arraySet(i, values[i]);
+        return;
+    }
+    Heap::SimpleArrayData *d = thisObject->d()->arrayData.cast<Heap::SimpleArrayData>();
+    if (d->values.size < len)
+        return;
+    for (uint i = 0; i < len; ++i)
+        d->setData(engine, i, values[i]);
 
 #ifdef CHECK_SPARSE_ARRAYS
     thisObject->initSparseArray();
@@ -60,7 +60,7 @@ Heap::CallContext *ExecutionContext::newBlockContext(CppStackFrame *frame, int b
 {
     Function *function = frame->v4Function;
 
-    Heap::InternalClass *ic = function->executableCompilationUnit()->runtimeBlocks.at(blockIndex);
+    Heap::InternalClass *ic = function->executableCompilationUnit()->runtimeBlockAt(blockIndex);
     uint nLocals = ic->size;
     size_t requiredMemory = sizeof(CallContext::Data) - sizeof(Value) + sizeof(Value) * nLocals;
 
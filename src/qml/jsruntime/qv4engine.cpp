@@ -436,6 +436,7 @@ ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
     jsStrings[String_sticky] = newIdentifier(QStringLiteral("sticky"));
     jsStrings[String_source] = newIdentifier(QStringLiteral("source"));
     jsStrings[String_flags] = newIdentifier(QStringLiteral("flags"));
+    jsStrings[String_toJSON] = newIdentifier(QStringLiteral("toJSON"));
 
     jsSymbols[Symbol_hasInstance] = Symbol::create(this, QStringLiteral("@Symbol.hasInstance"));
     jsSymbols[Symbol_isConcatSpreadable] = Symbol::create(this, QStringLiteral("@Symbol.isConcatSpreadable"));
@@ -414,6 +414,7 @@ public:
         String_sticky,
         String_source,
         String_flags,
+        String_toJSON,
 
         NJSStrings
     };
@@ -486,6 +487,7 @@ public:
     String *id_sticky() const { return reinterpret_cast<String *>(jsStrings + String_sticky); }
     String *id_source() const { return reinterpret_cast<String *>(jsStrings + String_source); }
     String *id_flags() const { return reinterpret_cast<String *>(jsStrings + String_flags); }
+    String *id_toJSON() const { return reinterpret_cast<String *>(jsStrings + String_toJSON); }
 
     Symbol *symbol_hasInstance() const { return reinterpret_cast<Symbol *>(jsSymbols + Symbol_hasInstance); }
     Symbol *symbol_isConcatSpreadable() const { return reinterpret_cast<Symbol *>(jsSymbols + Symbol_isConcatSpreadable); }
@@ -40,20 +40,66 @@
 #include "qv4estable_p.h"
 #include "qv4object_p.h"
 
+#include <QtCore/qhashfunctions.h>
+
+#include <algorithm>
+
 using namespace QV4;
 
 // The ES spec requires that Map/Set be implemented using a data structure that
 // is a little different from most; it requires nonlinear access, and must also
 // preserve the order of insertion of items in a deterministic way.
 //
-// This class implements those requirements, except for fast access: that
-// will be addressed in a followup patch.
+// The keys and values are kept in insertion order in flat arrays. An open
+// addressing hash table with linear probing maps keys to their position in
+// those arrays. Removed entries leave an empty key behind, so that the other
+// entries keep their position. The arrays are compacted once enough of those
+// have piled up.
+//
+// Each entry also gets a sequence number, increasing in insertion order.
+// Iterators remember the sequence number of the next entry to visit, so that
+// they can find their place again after the arrays were compacted.
+
+static const uint MinIndexCapacity = 16;
+
+// Returns the same hash for all keys that compare equal with SameValueZero.
+static uint hashKey(const Value &key)
+{
+    if (String *s = key.stringValue())
+        return s->hashValue();
+    if (key.isInteger())
+        return qHash(key.int_32());
+    if (key.isDouble()) {
+        const double d = key.doubleValue();
+        if (std::isnan(d))
+            return 0;
+        // 1 and 1.0 as well as 0 and -0 are the same key
+        if (d >= double(std::numeric_limits<int>::min()) && d <= double(std::numeric_limits<int>::max())
+                && double(int(d)) == d) {
+            return qHash(int(d));
+        }
+        return qHash(d);
+    }
+    return qHash(key.rawValue());
+}
+
+// Objects like QObject or variant wrappers can compare equal to other objects
+// that don't hash the same. While any of those is in the table, lookups fall
+// back to comparing with each key.
+static bool hasCustomEquality(const Value &key)
+{
+    const Managed *m = key.managed();
+    if (!m || m->vtable()->isString)
+        return false;
+    return m->vtable()->isEqualTo != Object::staticVTable()->isEqualTo;
+}
 
 ESTable::ESTable()
     : m_capacity(8)
 {
     m_keys = (Value*)malloc(m_capacity * sizeof(Value));
     m_values = (Value*)malloc(m_capacity * sizeof(Value));
+    m_sequenceNumbers = (quint64*)malloc(m_capacity * sizeof(quint64));
     memset(m_keys, 0, m_capacity);
     memset(m_values, 0, m_capacity);
 }
@@ -62,15 +108,22 @@ ESTable::~ESTable()
 {
     free(m_keys);
     free(m_values);
+    free(m_sequenceNumbers);
+    free(m_index);
     m_size = 0;
     m_capacity = 0;
     m_keys = nullptr;
     m_values = nullptr;
+    m_sequenceNumbers = nullptr;
+    m_index = nullptr;
+    m_indexCapacity = 0;
 }
 
 void ESTable::markObjects(MarkStack *s, bool isWeakMap)
 {
     for (uint i = 0; i < m_size; ++i) {
+        if (m_keys[i].isEmpty())
+            continue;
         if (!isWeakMap)
             m_keys[i].mark(s);
         m_values[i].mark(s);
@@ -82,24 +135,119 @@ void ESTable::markObjects(MarkStack *s, bool isWeakMap)
 void ESTable::clear()
 {
     m_size = 0;
+    m_removed = 0;
+    m_customEqualityKeys = 0;
+    if (m_index)
+        memset(m_index, 0, m_indexCapacity * sizeof(uint));
+}
+
+// Returns the position of \a key in the table, or UINT_MAX if it isn't there.
+uint ESTable::find(const Value &key) const
+{
+    if (m_customEqualityKeys) {
+        for (uint i = 0; i < m_size; ++i) {
+            if (!m_keys[i].isEmpty() && m_keys[i].sameValueZero(key))
+                return i;
+        }
+        return UINT_MAX;
+    }
+
+    if (!m_index)
+        return UINT_MAX;
+
+    const uint mask = m_indexCapacity - 1;
+    for (uint slot = hashKey(key) & mask; m_index[slot]; slot = (slot + 1) & mask) {
+        const uint idx = m_index[slot] - 1;
+        if (m_keys[idx].sameValueZero(key))
+            return idx;
+    }
+    return UINT_MAX;
+}
+
+void ESTable::insertIntoIndex(uint idx)
+{
+    const uint mask = m_indexCapacity - 1;
+    uint slot = hashKey(m_keys[idx]) & mask;
+    while (m_index[slot])
+        slot = (slot + 1) & mask;
+    m_index[slot] = idx + 1;
+}
+
+// Removes the entry at \a idx from the hash table.
+void ESTable::removeFromIndex(uint idx)
+{
+    const uint mask = m_indexCapacity - 1;
+    uint slot = hashKey(m_keys[idx]) & mask;
+    while (m_index[slot] != idx + 1)
+        slot = (slot + 1) & mask;
+
+    // Move the following entries of the probe sequence back, so that no gap is
+    // left between them and their ideal slot.
+    m_index[slot] = 0;
+    for (uint next = (slot + 1) & mask; m_index[next]; next = (next + 1) & mask) {
+        const uint ideal = hashKey(m_keys[m_index[next] - 1]) & mask;
+        const bool stays = (slot <= next) ? (slot < ideal && ideal <= next)
+                                          : (slot < ideal || ideal <= next);
+        if (stays)
+            continue;
+        m_index[slot] = m_index[next];
+        m_index[next] = 0;
+        slot = next;
+    }
+}
+
+void ESTable::rebuildIndex(uint capacity)
+{
+    if (capacity != m_indexCapacity) {
+        free(m_index);
+        m_index = (uint *)malloc(capacity * sizeof(uint));
+        m_indexCapacity = capacity;
+    }
+    memset(m_index, 0, m_indexCapacity * sizeof(uint));
+    for (uint i = 0; i < m_size; ++i) {
+        if (!m_keys[i].isEmpty())
+            insertIntoIndex(i);
+    }
+}
+
+// Drops the keys and values of removed entries from the arrays.
+void ESTable::compact()
+{
+    uint toIdx = 0;
+    for (uint idx = 0; idx < m_size; ++idx) {
+        if (m_keys[idx].isEmpty())
+            continue;
+        m_keys[toIdx] = m_keys[idx];
+        m_values[toIdx] = m_values[idx];
+        m_sequenceNumbers[toIdx] = m_sequenceNumbers[idx];
+        ++toIdx;
+    }
+    m_size = toIdx;
+    m_removed = 0;
+    if (m_index)
+        rebuildIndex(m_indexCapacity);
 }
 
 // Update the table to contain \a value for a given \a key. The key is
 // normalized, as required by the ES spec.
 void ESTable::set(const Value &key, const Value &value)
 {
-    for (uint i = 0; i < m_size; ++i) {
-        if (m_keys[i].sameValueZero(key)) {
-            m_values[i] = value;
-            return;
-        }
+    const uint idx = find(key);
+    if (idx != UINT_MAX) {
+        m_values[idx] = value;
+        return;
     }
 
+    // Reuse the positions of removed entries if they make up half of the table
+    if (m_capacity == m_size && m_removed * 2 >= m_size)
+        compact();
+
     if (m_capacity == m_size) {
         uint oldCap = m_capacity;
         m_capacity *= 2;
         m_keys = (Value*)realloc(m_keys, m_capacity * sizeof(Value));
         m_values = (Value*)realloc(m_values, m_capacity * sizeof(Value));
+        m_sequenceNumbers = (quint64*)realloc(m_sequenceNumbers, m_capacity * sizeof(quint64));
         memset(m_keys + oldCap, 0, m_capacity - oldCap);
         memset(m_values + oldCap, 0, m_capacity - oldCap);
     }
@@ -112,73 +260,86 @@ void ESTable::set(const Value &key, const Value &value)
 
     m_keys[m_size] = nk;
     m_values[m_size] = value;
+    m_sequenceNumbers[m_size] = m_nextSequenceNumber++;
 
     m_size++;
+    if (hasCustomEquality(nk))
+        ++m_customEqualityKeys;
+
+    // Keep the load factor of the index at 50% at most
+    if (size() * 2 > m_indexCapacity)
+        rebuildIndex(qMax(MinIndexCapacity, m_indexCapacity * 2));
+    else
+        insertIntoIndex(m_size - 1);
 }
 
 // Returns true if the table contains \a key, false otherwise.
 bool ESTable::has(const Value &key) const
 {
-    for (uint i = 0; i < m_size; ++i) {
-        if (m_keys[i].sameValueZero(key))
-            return true;
-    }
-
-    return false;
+    return find(key) != UINT_MAX;
 }
 
 // Fetches the value for the given \a key, and if \a hasValue is passed in,
 // it is set depending on whether or not the given key was found.
 ReturnedValue ESTable::get(const Value &key, bool *hasValue) const
 {
-    for (uint i = 0; i < m_size; ++i) {
-        if (m_keys[i].sameValueZero(key)) {
-            if (hasValue)
-                *hasValue = true;
-            return m_values[i].asReturnedValue();
-        }
-    }
-
+    const uint idx = find(key);
     if (hasValue)
-        *hasValue = false;
-    return Encode::undefined();
+        *hasValue = (idx != UINT_MAX);
+    if (idx == UINT_MAX)
+        return Encode::undefined();
+    return m_values[idx].asReturnedValue();
 }
 
 // Removes the given \a key from the table
 bool ESTable::remove(const Value &key)
 {
-    bool found = false;
-    uint idx = 0;
-    for (; idx < m_size; ++idx) {
-        if (m_keys[idx].sameValueZero(key)) {
-            found = true;
-            break;
-        }
-    }
+    const uint idx = find(key);
+    if (idx == UINT_MAX)
+        return false;
 
-    if (found == true) {
-        memmove(m_keys + idx, m_keys + idx + 1, (m_size - idx)*sizeof(Value));
-        memmove(m_values + idx, m_values + idx + 1, (m_size - idx)*sizeof(Value));
-        m_size--;
-    }
-    return found;
+    removeFromIndex(idx);
+    if (hasCustomEquality(m_keys[idx]))
+        --m_customEqualityKeys;
+
+    m_keys[idx] = Value::emptyValue();
+    m_values[idx] = Value::undefinedValue();
+    ++m_removed;
+    return true;
 }
 
-// Returns the size of the table. Note that the size may not match the underlying allocation.
+// Returns the number of entries in the table. Note that the size may not match the underlying allocation.
 uint ESTable::size() const
 {
-    return m_size;
+    return m_size - m_removed;
 }
 
-// Retrieves a key and value for a given \a idx, and places them in \a key and
-// \a value. They must be valid pointers.
-void ESTable::iterate(uint idx, Value *key, Value *value)
+// Retrieves the key and value of the next entry of an iteration, and places
+// them in \a key and \a value. They must be valid pointers. \a sequenceNumber
+// is the lowest sequence number the entry may have, \a idx is where the entry
+// was found the last time. Both are advanced past the entry. Returns false if
+// there is no such entry.
+bool ESTable::iterate(uint &idx, quint64 &sequenceNumber, Value *key, Value *value)
 {
-    Q_ASSERT(idx < m_size);
     Q_ASSERT(key);
     Q_ASSERT(value);
+
+    // The position is out of date if the arrays were compacted since.
+    const bool validPosition = idx <= m_size
+            && (idx == m_size || m_sequenceNumbers[idx] >= sequenceNumber)
+            && (idx == 0 || m_sequenceNumbers[idx - 1] < sequenceNumber);
+    if (!validPosition)
+        idx = std::lower_bound(m_sequenceNumbers, m_sequenceNumbers + m_size, sequenceNumber) - m_sequenceNumbers;
+
+    while (idx < m_size && m_keys[idx].isEmpty())
+        ++idx;
+    if (idx >= m_size)
+        return false;
     *key = m_keys[idx];
     *value = m_values[idx];
+    sequenceNumber = m_sequenceNumbers[idx] + 1;
+    ++idx;
+    return true;
 }
 
 void ESTable::removeUnmarkedKeys()
@@ -186,14 +347,25 @@ void ESTable::removeUnmarkedKeys()
     uint idx = 0;
     uint toIdx = 0;
     for (; idx < m_size; ++idx) {
+        if (m_keys[idx].isEmpty())
+            continue;
         Q_ASSERT(m_keys[idx].isObject());
         Object &o = static_cast<Object &>(m_keys[idx]);
         if (o.d()->isMarked()) {
             m_keys[toIdx] = m_keys[idx];
             m_values[toIdx] = m_values[idx];
+            m_sequenceNumbers[toIdx] = m_sequenceNumbers[idx];
             ++toIdx;
+        } else if (hasCustomEquality(m_keys[idx])) {
+            --m_customEqualityKeys;
         }
     }
+
+    if (toIdx == m_size)
+        return;
+
     m_size = toIdx;
+    m_removed = 0;
+    if (m_index)
+        rebuildIndex(m_indexCapacity);
 }
-
@@ -71,15 +71,31 @@ public:
     ReturnedValue get(const Value &k, bool *hasValue = nullptr) const;
     bool remove(const Value &k);
     uint size() const;
-    void iterate(uint idx, Value *k, Value *v);
+    bool iterate(uint &idx, quint64 &sequenceNumber, Value *k, Value *v);
 
     void removeUnmarkedKeys();
 
 private:
+    uint find(const Value &k) const;
+    void insertIntoIndex(uint idx);
+    void removeFromIndex(uint idx);
+    void rebuildIndex(uint capacity);
+    void compact();
+
     Value *m_keys = nullptr;
     Value *m_values = nullptr;
+    quint64 *m_sequenceNumbers = nullptr;
+    quint64 m_nextSequenceNumber = 0;
     uint m_size = 0;
     uint m_capacity = 0;
+    // Number of removed entries still taking up a position in the arrays
+    uint m_removed = 0;
+
+    // Open addressing hash table holding the positions in m_keys plus one, 0 marks a free slot
+    uint *m_index = nullptr;
+    uint m_indexCapacity = 0;
+    // Number of keys that can compare equal to values other than themselves
+    uint m_customEqualityKeys = 0;
 };
 
 }
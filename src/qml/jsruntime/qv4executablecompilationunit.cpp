@@ -145,23 +145,59 @@ QV4::Function *ExecutableCompilationUnit::linkToEngine(ExecutionEngine *engine)
     runtimeStrings = (QV4::Heap::String **)malloc(stringCount * sizeof(QV4::Heap::String*));
     // memset the strings to 0 in case a GC run happens while we're within the loop below
     memset(runtimeStrings, 0, stringCount * sizeof(QV4::Heap::String*));
+    // Unlike the tables below, the strings are created for each engine right away: the
+    // interpreter, the JIT and many runtime functions index runtimeStrings directly.
     for (uint i = 0; i < stringCount; ++i)
         runtimeStrings[i] = engine->newString(stringAt(i));
 
+    // Regular expressions, object literal classes and block classes are created on first use
+    // from the runtime, so that units with many functions that never run stay cheap to link.
     runtimeRegularExpressions
             = new QV4::Value[data->regexpTableSize];
-    // memset the regexps to 0 in case a GC run happens while we're within the loop below
     memset(runtimeRegularExpressions, 0,
            data->regexpTableSize * sizeof(QV4::Value));
-    for (uint i = 0; i < data->regexpTableSize; ++i) {
-        const CompiledData::RegExp *re = data->regexpAt(i);
-        uint f = re->flags;
-        const CompiledData::RegExp::Flags flags = static_cast<CompiledData::RegExp::Flags>(f);
-        runtimeRegularExpressions[i] = QV4::RegExp::create(
-                engine, stringAt(re->stringIndex), flags);
+
+    if (data->jsClassTableSize) {
+        runtimeClasses
+                = (QV4::Heap::InternalClass **)malloc(data->jsClassTableSize
+                                                      * sizeof(QV4::Heap::InternalClass *));
+        memset(runtimeClasses, 0,
+               data->jsClassTableSize * sizeof(QV4::Heap::InternalClass *));
     }
 
-    if (data->lookupTableSize) {
+    // Functions, and the lookups they share, are created when first needed. See
+    // runtimeFunctionAt().
+    runtimeFunctions.fill(nullptr, data->functionTableSize);
+
+    runtimeBlocks.fill(nullptr, data->blockTableSize);
+
+    static const bool showCode = qEnvironmentVariableIsSet("QV4_SHOW_BYTECODE");
+    if (showCode) {
+        qDebug() << "=== Constant table";
+        dumpConstantTable(constants, data->constantTableSize);
+        qDebug() << "=== String table";
+        for (uint i = 0, end = totalStringCount(); i < end; ++i)
+            qDebug() << "    " << i << ":" << runtimeStrings[i]->toQString();
+        qDebug() << "=== Closure table";
+        for (uint i = 0; i < data->functionTableSize; ++i)
+            qDebug() << "    " << i << ":" << stringAt(data->functionAt(i)->nameIndex);
+        qDebug() << "root function at index "
+                 << (data->indexOfRootFunction != -1
+                             ? data->indexOfRootFunction : 0);
+    }
+
+    if (data->indexOfRootFunction != -1)
+        return runtimeFunctionAt(data->indexOfRootFunction);
+    else
+        return nullptr;
+}
+
+QV4::Function *ExecutableCompilationUnit::createRuntimeFunction(int index)
+{
+    Q_ASSERT(engine);
+    Q_ASSERT(index < runtimeFunctions.size());
+
+    if (!runtimeLookups && data->lookupTableSize) {
         runtimeLookups = new QV4::Lookup[data->lookupTableSize];
         memset(runtimeLookups, 0, data->lookupTableSize * sizeof(QV4::Lookup));
         const CompiledData::Lookup *compiledLookups = data->lookupTable();
@@ -182,72 +218,61 @@ QV4::Function *ExecutableCompilationUnit::linkToEngine(ExecutionEngine *engine)
         }
     }
 
-    if (data->jsClassTableSize) {
-        runtimeClasses
-                = (QV4::Heap::InternalClass **)malloc(data->jsClassTableSize
-                                                      * sizeof(QV4::Heap::InternalClass *));
-        // memset the regexps to 0 in case a GC run happens while we're within the loop below
-        memset(runtimeClasses, 0,
-               data->jsClassTableSize * sizeof(QV4::Heap::InternalClass *));
-        for (uint i = 0; i < data->jsClassTableSize; ++i) {
-            int memberCount = 0;
-            const CompiledData::JSClassMember *member
-                    = data->jsClassAt(i, &memberCount);
-            runtimeClasses[i]
-                    = engine->internalClasses(QV4::ExecutionEngine::Class_Object);
-            for (int j = 0; j < memberCount; ++j, ++member)
-                runtimeClasses[i]
-                        = runtimeClasses[i]->addMember(
-                                engine->identifierTable->asPropertyKey(
-                                        runtimeStrings[member->nameOffset]),
-                                member->isAccessor
-                                        ? QV4::Attr_Accessor
-                                        : QV4::Attr_Data);
-        }
-    }
+    QV4::Function *f = QV4::Function::create(engine, this, data->functionAt(index));
+    runtimeFunctions[index] = f;
+    return f;
+}
 
-    runtimeFunctions.resize(data->functionTableSize);
-    for (int i = 0 ;i < runtimeFunctions.size(); ++i) {
-        const QV4::CompiledData::Function *compiledFunction = data->functionAt(i);
-        runtimeFunctions[i] = QV4::Function::create(engine, this, compiledFunction);
+ReturnedValue ExecutableCompilationUnit::runtimeRegularExpressionAt(int index)
+{
+    Q_ASSERT(index < int(data->regexpTableSize));
+    QV4::StaticValue &re = runtimeRegularExpressions[index];
+    if (re.isUndefined()) {
+        const CompiledData::RegExp *compiledRegExp = data->regexpAt(index);
+        const CompiledData::RegExp::Flags flags
+                = static_cast<CompiledData::RegExp::Flags>(uint(compiledRegExp->flags));
+        re = QV4::RegExp::create(engine, stringAt(compiledRegExp->stringIndex), flags);
     }
+    return re.asReturnedValue();
+}
+
+Heap::InternalClass *ExecutableCompilationUnit::runtimeClassAt(int index)
+{
+    Q_ASSERT(index < int(data->jsClassTableSize));
+    if (Heap::InternalClass *klass = runtimeClasses[index])
+        return klass;
 
     Scope scope(engine);
-    Scoped<InternalClass> ic(scope);
+    Scoped<InternalClass> ic(scope, engine->internalClasses(EngineBase::Class_Object));
+    int memberCount = 0;
+    const CompiledData::JSClassMember *member = data->jsClassAt(index, &memberCount);
+    for (int i = 0; i < memberCount; ++i, ++member)
+        ic = ic->addMember(engine->identifierTable->asPropertyKey(runtimeStrings[member->nameOffset]),
+                           member->isAccessor ? QV4::Attr_Accessor : QV4::Attr_Data);
 
-    runtimeBlocks.resize(data->blockTableSize);
-    for (int i = 0 ;i < runtimeBlocks.size(); ++i) {
-        const QV4::CompiledData::Block *compiledBlock = data->blockAt(i);
-        ic = engine->internalClasses(EngineBase::Class_CallContext);
+    runtimeClasses[index] = ic->d();
+    return runtimeClasses[index];
+}
 
-        // first locals
-        const quint32_le *localsIndices = compiledBlock->localsTable();
-        for (quint32 j = 0; j < compiledBlock->nLocals; ++j)
-            ic = ic->addMember(
-                    engine->identifierTable->asPropertyKey(runtimeStrings[localsIndices[j]]),
-                    Attr_NotConfigurable);
-        runtimeBlocks[i] = ic->d();
-    }
+Heap::InternalClass *ExecutableCompilationUnit::runtimeBlockAt(int index)
+{
+    Q_ASSERT(index < runtimeBlocks.size());
+    if (Heap::InternalClass *block = runtimeBlocks.at(index))
+        return block;
 
-    static const bool showCode = qEnvironmentVariableIsSet("QV4_SHOW_BYTECODE");
-    if (showCode) {
-        qDebug() << "=== Constant table";
-        dumpConstantTable(constants, data->constantTableSize);
-        qDebug() << "=== String table";
-        for (uint i = 0, end = totalStringCount(); i < end; ++i)
-            qDebug() << "    " << i << ":" << runtimeStrings[i]->toQString();
-        qDebug() << "=== Closure table";
-        for (uint i = 0; i < data->functionTableSize; ++i)
-            qDebug() << "    " << i << ":" << runtimeFunctions[i]->name()->toQString();
-        qDebug() << "root function at index "
-                 << (data->indexOfRootFunction != -1
-                             ? data->indexOfRootFunction : 0);
-    }
+    Scope scope(engine);
+    Scoped<InternalClass> ic(scope, engine->internalClasses(EngineBase::Class_CallContext));
 
-    if (data->indexOfRootFunction != -1)
-        return runtimeFunctions[data->indexOfRootFunction];
-    else
-        return nullptr;
+    // first locals
+    const QV4::CompiledData::Block *compiledBlock = data->blockAt(index);
+    const quint32_le *localsIndices = compiledBlock->localsTable();
+    for (quint32 i = 0; i < compiledBlock->nLocals; ++i)
+        ic = ic->addMember(
+                engine->identifierTable->asPropertyKey(runtimeStrings[localsIndices[i]]),
+                Attr_NotConfigurable);
+
+    runtimeBlocks[index] = ic->d();
+    return runtimeBlocks.at(index);
 }
 
 Heap::Object *ExecutableCompilationUnit::templateObjectAt(int index) const
@@ -294,11 +319,12 @@ void ExecutableCompilationUnit::unlink()
     }
 
     propertyCaches.clear();
+    requiredPropertiesPerObject.clear();
 
     if (runtimeLookups) {
         for (uint i = 0; i < data->lookupTableSize; ++i) {
             QV4::Lookup &l = runtimeLookups[i];
-            if (l.getter == QV4::QObjectWrapper::lookupGetter
+            if (QV4::QObjectWrapper::isLookupGetter(l.getter)
                     || l.getter == QQmlTypeWrapper::lookupSingletonProperty) {
                 if (QQmlPropertyCache *pc = l.qobjectLookup.propertyCache)
                     pc->release();
@@ -309,7 +335,8 @@ void ExecutableCompilationUnit::unlink()
             }
 
             if (l.qmlContextPropertyGetter == QQmlContextWrapper::lookupScopeObjectProperty
-                    || l.qmlContextPropertyGetter == QQmlContextWrapper::lookupContextObjectProperty) {
+                    || l.qmlContextPropertyGetter == QQmlContextWrapper::lookupContextObjectProperty
+                    || l.qmlContextPropertyGetter == QQmlContextWrapper::lookupParentContextObjectProperty) {
                 if (QQmlPropertyCache *pc = l.qobjectLookup.propertyCache)
                     pc->release();
             }
@@ -329,8 +356,10 @@ void ExecutableCompilationUnit::unlink()
     delete [] runtimeLookups;
     runtimeLookups = nullptr;
 
-    for (QV4::Function *f : qAsConst(runtimeFunctions))
-        f->destroy();
+    for (QV4::Function *f : qAsConst(runtimeFunctions)) {
+        if (f)
+            f->destroy();
+    }
     runtimeFunctions.clear();
 
     free(runtimeStrings);
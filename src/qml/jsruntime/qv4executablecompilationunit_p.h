@@ -89,6 +89,23 @@ namespace QV4 {
 // index is per-object binding index
 typedef QVector<QQmlPropertyData*> BindingPropertyData;
 
+struct RequiredPropertyData
+{
+    QQmlPropertyData *property;
+    QString name;
+    CompiledData::Location location;
+};
+
+// The required properties of one object, collected by QQmlObjectCreator on the first
+// instantiation and reused for every further one.
+struct ObjectRequiredProperties
+{
+    QVector<RequiredPropertyData> properties;
+    // set if the object marks an inherited property as required that does not exist
+    QString missingPropertyName;
+    bool collected = false;
+};
+
 class CompilationUnitMapper;
 struct ResolvedTypeReference;
 // map from name index
@@ -158,6 +175,9 @@ public:
     // lookups by string (property name).
     QVector<BindingPropertyData> bindingPropertyDataPerObject;
 
+    // index is object index. Initialized on demand by QQmlObjectCreator.
+    QVector<ObjectRequiredProperties> requiredPropertiesPerObject;
+
     // mapping from component object index (CompiledData::Unit object index that points to component) to identifier hash of named objects
     // this is initialized on-demand by QQmlContextData
     QHash<int, IdentifierHash> namedObjectsPerComponentCache;
@@ -207,6 +227,15 @@ public:
     }
 
     Heap::Object *templateObjectAt(int index) const;
+    QV4::Function *runtimeFunctionAt(int index)
+    {
+        if (QV4::Function *f = runtimeFunctions.at(index))
+            return f;
+        return createRuntimeFunction(index);
+    }
+    ReturnedValue runtimeRegularExpressionAt(int index);
+    Heap::InternalClass *runtimeClassAt(int index);
+    Heap::InternalClass *runtimeBlockAt(int index);
 
     struct FunctionIterator
     {
@@ -314,6 +343,7 @@ private:
     QUrl urlAt(int index) const { return QUrl(stringAt(index)); }
 
     Q_NEVER_INLINE IdentifierHash createNamedObjectsPerComponent(int componentObjectIndex);
+    Q_NEVER_INLINE QV4::Function *createRuntimeFunction(int index);
     const CompiledData::ExportEntry *lookupNameInExportTable(
             const CompiledData::ExportEntry *firstExportEntry, int tableSize,
             QV4::String *name) const;
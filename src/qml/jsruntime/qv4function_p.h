@@ -132,6 +132,7 @@ public:
     inline bool isStrict() const { return compiledFunction->flags & CompiledData::Function::IsStrict; }
     inline bool isArrowFunction() const { return compiledFunction->flags & CompiledData::Function::IsArrowFunction; }
     inline bool isGenerator() const { return compiledFunction->flags & CompiledData::Function::IsGenerator; }
+    inline bool ignoresArguments() const { return compiledFunction->flags & CompiledData::Function::IgnoresArguments; }
 
     QQmlSourceLocation sourceLocation() const;
 
@@ -139,7 +140,7 @@ public:
     {
         if (compiledFunction->nestedFunctionIndex == std::numeric_limits<uint32_t>::max())
             return nullptr;
-        return executableCompilationUnit()->runtimeFunctions[compiledFunction->nestedFunctionIndex];
+        return executableCompilationUnit()->runtimeFunctionAt(compiledFunction->nestedFunctionIndex);
     }
 };
 
@@ -320,8 +320,7 @@ void InternalClass::destroy()
         }
     }
 
-    if (parent && parent->engine && parent->isMarked())
-        parent->removeChildEntry(this);
+    detachFromParent();
 
     propertyTable.~PropertyHash();
     nameMap.~SharedInternalClassData<PropertyKey>();
@@ -331,6 +330,14 @@ void InternalClass::destroy()
     Base::destroy();
 }
 
+void InternalClass::detachFromParent()
+{
+    if (parent && parent->engine && parent->isMarked()) {
+        parent->removeChildEntry(this);
+        parent = nullptr;
+    }
+}
+
 QString InternalClass::keyAt(uint index) const
 {
     return nameMap.at(index).toQString();
@@ -351,6 +358,15 @@ InternalClassTransition &InternalClass::lookupOrInsertTransition(const InternalC
     if (it != transitions.end() && *it == t) {
         return *it;
     } else {
+        // removeChildEntry() only clears the transitions to classes that got collected, as it
+        // runs during the sweep. Drop them here, so that classes with many short lived children,
+        // like the ones of parsed JSON objects, don't keep growing their transition tables.
+        const auto isDead = [](const Transition &transition) { return !transition.lookup; };
+        const auto dead = std::remove_if(transitions.begin(), transitions.end(), isDead);
+        if (dead != transitions.end()) {
+            transitions.erase(dead, transitions.end());
+            it = std::lower_bound(transitions.begin(), transitions.end(), t);
+        }
         it = transitions.insert(it, t);
         return *it;
     }
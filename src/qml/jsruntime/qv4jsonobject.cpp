@@ -48,6 +48,7 @@
 #include "qv4string_p.h"
 #include "qv4jscall_p.h"
 #include <qv4symbol_p.h>
+#include <qv4identifiertable_p.h>
 
 #include <qstack.h>
 #include <qstringlist.h>
@@ -261,7 +262,9 @@ bool JsonParser::parseMember(Object *o)
     if (!parseValue(val))
         return false;
 
-    ScopedString s(scope, engine->newString(key));
+    // Keys usually repeat across the objects of a document, so look them up in the identifier
+    // table right away instead of allocating a new string for each of them.
+    ScopedString s(scope, engine->identifierTable->insertString(key));
     PropertyKey skey = s->toPropertyKey();
     if (skey.isArrayIndex()) {
         o->put(skey.asArrayIndex(), val);
@@ -443,8 +446,10 @@ bool JsonParser::parseNumber(Value *val)
     bool isInt = true;
 
     // minus
-    if (json < end && *json == '-')
+    const bool negative = json < end && *json == '-';
+    if (negative)
         ++json;
+    const QChar *digits = json;
 
     // int = zero / ( digit1-9 *DIGIT )
     if (json < end && *json == '0') {
@@ -472,6 +477,16 @@ bool JsonParser::parseNumber(Value *val)
             ++json;
     }
 
+    // Small integers don't need to go through a temporary string
+    if (isInt && json > digits && json - digits <= 7) {
+        int n = 0;
+        for (const QChar *c = digits; c < json; ++c)
+            n = n * 10 + (c->unicode() - '0');
+        *val = Value::fromInt32(negative ? -n : n);
+        END;
+        return true;
+    }
+
     QString number(start, json - start);
     DEBUG << "numberstring" << number;
 
@@ -585,6 +600,15 @@ bool JsonParser::parseString(QString *string)
     BEGIN << "parse string stringPos=" << json;
 
     while (json < end) {
+        // Copy the runs of unescaped characters in one go
+        const QChar *run = json;
+        while (json < end && *json != '"' && *json != '\\' && json->unicode() > 0x1f)
+            ++json;
+        if (json != run)
+            string->append(run, int(json - run));
+        if (json >= end)
+            break;
+
         if (*json == '"')
             break;
         else if (*json == '\\') {
@@ -599,12 +623,8 @@ bool JsonParser::parseString(QString *string)
                 *string += QChar(ch);
             }
         } else {
-            if (json->unicode() <= 0x1f) {
-                lastError = QJsonParseError::IllegalEscapeSequence;
-                return false;
-            }
-            *string += *json;
-            ++json;
+            lastError = QJsonParseError::IllegalEscapeSequence;
+            return false;
         }
     }
     ++json;
@@ -629,6 +649,10 @@ struct Stringify
     QString indent;
     QStack<Object *> stack;
 
+    // All values are serialized into this one buffer, so that the text of nested objects
+    // doesn't get copied again on each level.
+    QString result;
+
     bool stackContains(Object *o) {
         for (int i = 0; i < stack.size(); ++i)
             if (stack.at(i)->d() == o->d())
@@ -638,22 +662,30 @@ struct Stringify
 
     Stringify(ExecutionEngine *e) : v4(e), replacerFunction(nullptr), propertyList(nullptr), propertyListSize(0) {}
 
-    QString Str(const QString &key, const Value &v);
-    QString JA(Object *a);
-    QString JO(Object *o);
+    bool Str(const QString &key, const Value &v);
+    void JA(Object *a);
+    void JO(Object *o);
 
-    QString makeMember(const QString &key, const Value &v);
+    void makeMember(const QString &key, const Value &v, bool *empty);
 };
 
-static QString quote(const QString &str)
+static void quote(QString &product, const QString &str)
 {
-    QString product;
+    const QChar *data = str.constData();
     const int length = str.length();
-    product.reserve(length + 2);
     product += QLatin1Char('"');
+
+    // Copy the runs of characters that don't need escaping in one go
+    int runStart = 0;
     for (int i = 0; i < length; ++i) {
-        QChar c = str.at(i);
-        switch (c.unicode()) {
+        const ushort c = data[i].unicode();
+        if (c > 0x1f && c != '"' && c != '\\')
+            continue;
+
+        product.append(data + runStart, i - runStart);
+        runStart = i + 1;
+
+        switch (c) {
         case '"':
             product += QLatin1String("\\\"");
             break;
@@ -676,35 +708,30 @@ static QString quote(const QString &str)
             product += QLatin1String("\\t");
             break;
         default:
-            if (c.unicode() <= 0x1f) {
-                product += QLatin1String("\\u00");
-                product += (c.unicode() > 0xf ? QLatin1Char('1') : QLatin1Char('0')) +
-                        QLatin1Char("0123456789abcdef"[c.unicode() & 0xf]);
-            } else {
-                product += c;
-            }
+            product += QLatin1String("\\u00");
+            product += (c > 0xf ? QLatin1Char('1') : QLatin1Char('0'));
+            product += QLatin1Char("0123456789abcdef"[c & 0xf]);
         }
     }
+    product.append(data + runStart, length - runStart);
     product += QLatin1Char('"');
-    return product;
 }
 
-QString Stringify::Str(const QString &key, const Value &v)
+bool Stringify::Str(const QString &key, const Value &v)
 {
     Scope scope(v4);
 
     ScopedValue value(scope, v);
     ScopedObject o(scope, value);
     if (o) {
-        ScopedString s(scope, v4->newString(QStringLiteral("toJSON")));
-        ScopedFunctionObject toJSON(scope, o->get(s));
+        ScopedFunctionObject toJSON(scope, o->get(v4->id_toJSON()));
         if (!!toJSON) {
             JSCallData jsCallData(scope, 1);
             *jsCallData->thisObject = value;
             jsCallData->args[0] = v4->newString(key);
             value = toJSON->call(jsCallData);
             if (v4->hasException)
-                return QString();
+                return false;
         }
     }
 
@@ -717,7 +744,7 @@ QString Stringify::Str(const QString &key, const Value &v)
         *jsCallData->thisObject = holder;
         value = replacerFunction->call(jsCallData);
         if (v4->hasException)
-            return QString();
+            return false;
     }
 
     o = value->asReturnedValue();
@@ -730,64 +757,82 @@ QString Stringify::Str(const QString &key, const Value &v)
             value = Encode(b->value());
     }
 
-    if (value->isNull())
-        return QStringLiteral("null");
-    if (value->isBoolean())
-        return value->booleanValue() ? QStringLiteral("true") : QStringLiteral("false");
-    if (value->isString())
-        return quote(value->stringValue()->toQString());
+    if (value->isNull()) {
+        result += QLatin1String("null");
+        return true;
+    }
+    if (value->isBoolean()) {
+        result += value->booleanValue() ? QLatin1String("true") : QLatin1String("false");
+        return true;
+    }
+    if (value->isString()) {
+        quote(result, value->stringValue()->toQString());
+        return true;
+    }
 
     if (value->isNumber()) {
         double d = value->toNumber();
-        return std::isfinite(d) ? value->toQString() : QStringLiteral("null");
+        if (std::isfinite(d))
+            result += value->toQString();
+        else
+            result += QLatin1String("null");
+        return true;
     }
 
     if (const QV4::VariantObject *v = value->as<QV4::VariantObject>()) {
-        return quote(v->d()->data().toString());
+        quote(result, v->d()->data().toString());
+        return true;
     }
 
     o = value->asReturnedValue();
     if (o) {
         if (!o->as<FunctionObject>()) {
-            if (o->isArrayLike()) {
-                return JA(o.getPointer());
-            } else {
-                return JO(o);
-            }
+            if (o->isArrayLike())
+                JA(o.getPointer());
+            else
+                JO(o);
+            return true;
         }
     }
 
-    return QString();
+    return false;
 }
 
-QString Stringify::makeMember(const QString &key, const Value &v)
+void Stringify::makeMember(const QString &key, const Value &v, bool *empty)
 {
-    QString strP = Str(key, v);
-    if (!strP.isEmpty()) {
-        QString member = quote(key) + QLatin1Char(':');
-        if (!gap.isEmpty())
-            member += QLatin1Char(' ');
-        member += strP;
-        return member;
+    const int rollback = result.length();
+    if (!*empty)
+        result += QLatin1Char(',');
+    if (!gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += indent;
     }
-    return QString();
+    quote(result, key);
+    result += QLatin1Char(':');
+    if (!gap.isEmpty())
+        result += QLatin1Char(' ');
+
+    if (Str(key, v))
+        *empty = false;
+    else
+        result.truncate(rollback);
 }
 
-QString Stringify::JO(Object *o)
+void Stringify::JO(Object *o)
 {
     if (stackContains(o)) {
         v4->throwTypeError();
-        return QString();
+        return;
     }
 
     Scope scope(v4);
 
-    QString result;
     stack.push(o);
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    result += QLatin1Char('{');
+    bool empty = true;
     if (!propertyListSize) {
         ObjectIterator it(scope, o, ObjectIterator::EnumerableOnly);
         ScopedValue name(scope);
@@ -797,10 +842,7 @@ QString Stringify::JO(Object *o)
             name = it.nextPropertyNameAsString(val);
             if (name->isNull())
                 break;
-            QString key = name->toQString();
-            QString member = makeMember(key, val);
-            if (!member.isEmpty())
-                partial += member;
+            makeMember(name->toQString(), val, &empty);
         }
     } else {
         ScopedValue v(scope);
@@ -812,70 +854,58 @@ QString Stringify::JO(Object *o)
             v = o->get(s, &exists);
             if (!exists)
                 continue;
-            QString member = makeMember(s->toQString(), v);
-            if (!member.isEmpty())
-                partial += member;
+            makeMember(s->toQString(), v, &empty);
         }
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("{}");
-    } else if (gap.isEmpty()) {
-        result = QLatin1Char('{') + partial.join(QLatin1Char(',')) + QLatin1Char('}');
-    } else {
-        QString separator = QLatin1String(",\n") + indent;
-        result = QLatin1String("{\n") + indent + partial.join(separator) + QLatin1Char('\n')
-                 + stepback + QLatin1Char('}');
+    if (!empty && !gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += stepback;
     }
+    result += QLatin1Char('}');
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
-QString Stringify::JA(Object *a)
+void Stringify::JA(Object *a)
 {
     if (stackContains(a)) {
         v4->throwTypeError();
-        return QString();
+        return;
     }
 
     Scope scope(a->engine());
 
-    QString result;
     stack.push(a);
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    result += QLatin1Char('[');
     uint len = a->getLength();
     ScopedValue v(scope);
     for (uint i = 0; i < len; ++i) {
+        if (i)
+            result += QLatin1Char(',');
+        if (!gap.isEmpty()) {
+            result += QLatin1Char('\n');
+            result += indent;
+        }
+
         bool exists;
         v = a->get(i, &exists);
-        if (!exists) {
-            partial += QStringLiteral("null");
-            continue;
-        }
-        QString strP = Str(QString::number(i), v);
-        if (!strP.isEmpty())
-            partial += strP;
-        else
-            partial += QStringLiteral("null");
+        if (!exists || !Str(QString::number(i), v))
+            result += QLatin1String("null");
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("[]");
-    } else if (gap.isEmpty()) {
-        result = QLatin1Char('[') + partial.join(QLatin1Char(',')) + QLatin1Char(']');
-    } else {
-        QString separator = QLatin1String(",\n") + indent;
-        result = QLatin1String("[\n") + indent + partial.join(separator) + QLatin1Char('\n') + stepback + QLatin1Char(']');
+    if (len && !gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += stepback;
     }
+    result += QLatin1Char(']');
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
 
@@ -955,10 +985,9 @@ ReturnedValue JsonObject::method_stringify(const FunctionObject *b, const Value
 
 
     ScopedValue arg0(scope, argc ? argv[0] : Value::undefinedValue());
-    QString result = stringify.Str(QString(), arg0);
-    if (result.isEmpty() || scope.engine->hasException)
+    if (!stringify.Str(QString(), arg0) || scope.engine->hasException)
         RETURN_UNDEFINED();
-    return Encode(scope.engine->newString(result));
+    return Encode(scope.engine->newString(stringify.result));
 }
 
 
@@ -61,7 +61,7 @@ void Heap::Module::init(ExecutionEngine *engine, ExecutableCompilationUnit *modu
     unit = moduleUnit;
     self.set(engine, this);
 
-    Function *moduleFunction = unit->runtimeFunctions[unit->unitData()->indexOfRootFunction];
+    Function *moduleFunction = unit->runtimeFunctionAt(unit->unitData()->indexOfRootFunction);
 
     const uint locals = moduleFunction->compiledFunction->nLocals;
     const size_t requiredMemory = sizeof(QV4::CallContext::Data) - sizeof(Value) + sizeof(Value) * locals;
@@ -111,7 +111,7 @@ void Module::evaluate()
     unit->evaluateModuleRequests();
 
     ExecutionEngine *v4 = engine();
-    Function *moduleFunction = unit->runtimeFunctions[unit->data->indexOfRootFunction];
+    Function *moduleFunction = unit->runtimeFunctionAt(unit->data->indexOfRootFunction);
     CppStackFrame frame;
     frame.init(v4, moduleFunction, nullptr, 0);
     frame.setupJSFrame(v4->jsStackTop, Value::undefinedValue(), d()->scope,
@@ -642,11 +642,27 @@ ReturnedValue QQmlContextWrapper::lookupInParentContextHierarchy(Lookup *l, Exec
         // Search context object
         if (context->contextObject) {
             bool hasProp = false;
+            QQmlPropertyData *propertyData = nullptr;
             result = QV4::QObjectWrapper::getQmlProperty(engine, context, context->contextObject,
-                                                         name, QV4::QObjectWrapper::CheckRevision, &hasProp);
+                                                         name, QV4::QObjectWrapper::CheckRevision, &hasProp, &propertyData);
             if (hasProp) {
+                ScopedValue val(scope, QV4::QObjectWrapper::wrap(engine, context->contextObject));
                 if (base)
-                    *base = QV4::QObjectWrapper::wrap(engine, context->contextObject);
+                    *base = val;
+
+                // The context object of the immediate parent context is typically the same kind
+                // of object each time the lookup runs, for example the model item of a delegate.
+                if (propertyData && context == expressionContext->parent) {
+                    QQmlData *ddata = QQmlData::get(context->contextObject, false);
+                    if (ddata && ddata->propertyCache) {
+                        const QObjectWrapper *That = static_cast<const QObjectWrapper *>(val->objectValue());
+                        l->qobjectLookup.ic = That->internalClass();
+                        l->qobjectLookup.propertyCache = ddata->propertyCache;
+                        l->qobjectLookup.propertyCache->addref();
+                        l->qobjectLookup.propertyData = propertyData;
+                        l->qmlContextPropertyGetter = QQmlContextWrapper::lookupParentContextObjectProperty;
+                    }
+                }
 
                 return result->asReturnedValue();
             }
@@ -663,6 +679,48 @@ ReturnedValue QQmlContextWrapper::lookupInParentContextHierarchy(Lookup *l, Exec
     return Encode::undefined();
 }
 
+ReturnedValue QQmlContextWrapper::lookupParentContextObjectProperty(Lookup *l, ExecutionEngine *engine, Value *base)
+{
+    Scope scope(engine);
+    Scoped<QmlContext> qmlContext(scope, engine->qmlContext());
+    if (!qmlContext)
+        return QV4::Encode::undefined();
+
+    QQmlContextData *context = qmlContext->qmlContext();
+    if (!context)
+        return QV4::Encode::undefined();
+
+    const auto revertLookup = [l, engine, base]() {
+        l->qobjectLookup.propertyCache->release();
+        l->qobjectLookup.propertyCache = nullptr;
+        l->qmlContextPropertyGetter = QQmlContextWrapper::lookupInParentContextHierarchy;
+        return QQmlContextWrapper::lookupInParentContextHierarchy(l, engine, base);
+    };
+
+    QQmlContextData *parentContext = context->parent;
+    if (!parentContext || !parentContext->contextObject)
+        return revertLookup();
+
+    // Ids and context properties of the parent context take precedence over its context object.
+    const QV4::IdentifierHash &properties = parentContext->propertyNames();
+    if (properties.count() != 0) {
+        ScopedString name(scope, engine->currentStackFrame->v4Function->compilationUnit->runtimeStrings[l->nameIndex]);
+        if (properties.value(name) != -1)
+            return revertLookup();
+    }
+
+    QObject *contextObject = parentContext->contextObject;
+    if (QQmlData::wasDeleted(contextObject))
+        return QV4::Encode::undefined();
+
+    ScopedValue obj(scope, QV4::QObjectWrapper::wrap(engine, contextObject));
+
+    if (base)
+        *base = obj;
+
+    return QObjectWrapper::lookupGetterImpl(l, engine, obj, /*useOriginalProperty*/ true, revertLookup);
+}
+
 ReturnedValue QQmlContextWrapper::lookupType(Lookup *l, ExecutionEngine *engine, Value *base)
 {
     Scope scope(engine);
@@ -838,6 +838,95 @@ OwnPropertyKeyIterator *QObjectWrapper::virtualOwnPropertyKeys(const Object *m,
     return new QObjectWrapperOwnPropertyKeyIterator;
 }
 
+static ReturnedValue revertQObjectLookup(Lookup *lookup, ExecutionEngine *engine, const Value &object)
+{
+    lookup->qobjectLookup.propertyCache->release();
+    lookup->qobjectLookup.propertyCache = nullptr;
+    lookup->getter = Lookup::getterGeneric;
+    return Lookup::getterGeneric(lookup, engine, object);
+}
+
+// The type specialized lookup getters below only do what getProperty() does for plain
+// properties of the given type. They skip the checks for methods and var properties, and the
+// type dispatch in loadProperty().
+
+static inline ReturnedValue encodeProperty(ExecutionEngine *, int v) { return Encode(v); }
+static inline ReturnedValue encodeProperty(ExecutionEngine *, uint v) { return Encode(v); }
+static inline ReturnedValue encodeProperty(ExecutionEngine *, bool v) { return Encode(v); }
+static inline ReturnedValue encodeProperty(ExecutionEngine *, double v) { return Encode(v); }
+static inline ReturnedValue encodeProperty(ExecutionEngine *, float v) { return Encode(double(v)); }
+
+static inline ReturnedValue encodeProperty(ExecutionEngine *engine, const QString &v)
+{
+    return engine->newString(v)->asReturnedValue();
+}
+
+static inline ReturnedValue encodeProperty(ExecutionEngine *engine, QObject *v)
+{
+    return QObjectWrapper::wrap(engine, v);
+}
+
+template <typename T>
+static ReturnedValue loadTypedProperty(ExecutionEngine *engine, QObject *object, QQmlPropertyData *property)
+{
+    QQmlData::flushPendingBinding(object, QQmlPropertyIndex(property->coreIndex()));
+
+    if (!property->isConstant()) {
+        if (QQmlEngine *qmlEngine = engine->qmlEngine()) {
+            QQmlEnginePrivate *ep = QQmlEnginePrivate::get(qmlEngine);
+            if (ep->propertyCapture)
+                ep->propertyCapture->captureProperty(object, property->coreIndex(), property->notifyIndex());
+        }
+    }
+
+    T v = T();
+    property->readProperty(object, &v);
+    return encodeProperty(engine, v);
+}
+
+template <typename T>
+static ReturnedValue lookupGetterForType(Lookup *lookup, ExecutionEngine *engine, const Value &object)
+{
+    const auto revertLookup = [lookup, engine, &object]() {
+        return revertQObjectLookup(lookup, engine, object);
+    };
+
+    return QObjectWrapper::lookupGetterImpl(lookup, engine, object, /*useOriginalProperty*/ false,
+                                            revertLookup, &loadTypedProperty<T>);
+}
+
+// Keep this in sync with loadProperty()
+static ReturnedValue (*typedLookupGetter(const QQmlPropertyData *property))(Lookup *, ExecutionEngine *, const Value &)
+{
+    if (property->isFunction() || property->isVarProperty())
+        return QObjectWrapper::lookupGetter;
+    if (property->isQObject())
+        return lookupGetterForType<QObject *>;
+    if (property->isQList())
+        return QObjectWrapper::lookupGetter;
+
+    switch (property->propType()) {
+    case QMetaType::Double:
+        return lookupGetterForType<double>;
+    case QMetaType::Float:
+        return lookupGetterForType<float>;
+    case QMetaType::Int:
+        return lookupGetterForType<int>;
+    case QMetaType::Bool:
+        return lookupGetterForType<bool>;
+    case QMetaType::QString:
+        return lookupGetterForType<QString>;
+    case QMetaType::UInt:
+        return lookupGetterForType<uint>;
+    default:
+        break;
+    }
+
+    if (property->isEnum())
+        return lookupGetterForType<int>;
+    return QObjectWrapper::lookupGetter;
+}
+
 ReturnedValue QObjectWrapper::virtualResolveLookupGetter(const Object *object, ExecutionEngine *engine, Lookup *lookup)
 {
     // Keep this code in sync with ::getQmlProperty
@@ -880,22 +969,31 @@ ReturnedValue QObjectWrapper::virtualResolveLookupGetter(const Object *object, E
     lookup->qobjectLookup.propertyCache = ddata->propertyCache;
     lookup->qobjectLookup.propertyCache->addref();
     lookup->qobjectLookup.propertyData = property;
-    lookup->getter = QV4::QObjectWrapper::lookupGetter;
+    lookup->getter = typedLookupGetter(property);
     return lookup->getter(lookup, engine, *object);
 }
 
 ReturnedValue QObjectWrapper::lookupGetter(Lookup *lookup, ExecutionEngine *engine, const Value &object)
 {
     const auto revertLookup = [lookup, engine, &object]() {
-        lookup->qobjectLookup.propertyCache->release();
-        lookup->qobjectLookup.propertyCache = nullptr;
-        lookup->getter = Lookup::getterGeneric;
-        return Lookup::getterGeneric(lookup, engine, object);
+        return revertQObjectLookup(lookup, engine, object);
     };
 
     return lookupGetterImpl(lookup, engine, object, /*useOriginalProperty*/ false, revertLookup);
 }
 
+bool QObjectWrapper::isLookupGetter(ReturnedValue (*getter)(Lookup *, ExecutionEngine *, const Value &))
+{
+    return getter == lookupGetter
+            || getter == lookupGetterForType<QObject *>
+            || getter == lookupGetterForType<double>
+            || getter == lookupGetterForType<float>
+            || getter == lookupGetterForType<int>
+            || getter == lookupGetterForType<bool>
+            || getter == lookupGetterForType<QString>
+            || getter == lookupGetterForType<uint>;
+}
+
 bool QObjectWrapper::virtualResolveLookupSetter(Object *object, ExecutionEngine *engine, Lookup *lookup,
                                                 const Value &value)
 {
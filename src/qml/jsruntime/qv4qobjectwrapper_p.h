@@ -184,7 +184,9 @@ struct Q_QML_EXPORT QObjectWrapper : public Object
 
     static ReturnedValue virtualResolveLookupGetter(const Object *object, ExecutionEngine *engine, Lookup *lookup);
     static ReturnedValue lookupGetter(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static bool isLookupGetter(ReturnedValue (*getter)(Lookup *, ExecutionEngine *, const Value &));
     template <typename ReversalFunctor> static ReturnedValue lookupGetterImpl(Lookup *l, ExecutionEngine *engine, const Value &object, bool useOriginalProperty, ReversalFunctor revert);
+    template <typename ReversalFunctor, typename PropertyLoader> static ReturnedValue lookupGetterImpl(Lookup *l, ExecutionEngine *engine, const Value &object, bool useOriginalProperty, ReversalFunctor revert, PropertyLoader load);
     static bool virtualResolveLookupSetter(Object *object, ExecutionEngine *engine, Lookup *lookup, const Value &value);
 
 protected:
@@ -224,6 +226,12 @@ inline ReturnedValue QObjectWrapper::wrap(ExecutionEngine *engine, QObject *obje
 
 template <typename ReversalFunctor>
 inline ReturnedValue QObjectWrapper::lookupGetterImpl(Lookup *lookup, ExecutionEngine *engine, const Value &object, bool useOriginalProperty, ReversalFunctor revertLookup)
+{
+    return lookupGetterImpl(lookup, engine, object, useOriginalProperty, revertLookup, &getProperty);
+}
+
+template <typename ReversalFunctor, typename PropertyLoader>
+inline ReturnedValue QObjectWrapper::lookupGetterImpl(Lookup *lookup, ExecutionEngine *engine, const Value &object, bool useOriginalProperty, ReversalFunctor revertLookup, PropertyLoader load)
 {
     // we can safely cast to a QV4::Object here. If object is something else,
     // the internal class won't match
@@ -259,7 +267,7 @@ inline ReturnedValue QObjectWrapper::lookupGetterImpl(Lookup *lookup, ExecutionE
             return revertLookup();
     }
 
-    return getProperty(engine, qobj, property);
+    return load(engine, qobj, property);
 }
 
 struct QQmlValueTypeWrapper;
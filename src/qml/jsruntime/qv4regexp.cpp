@@ -43,8 +43,12 @@
 #include <private/qv4mm_p.h>
 #include <runtime/VM.h>
 
+#include <QtCore/qloggingcategory.h>
+
 using namespace QV4;
 
+Q_LOGGING_CATEGORY(lcRegExpStats, "qt.qml.regexp.statistics")
+
 static JSC::RegExpFlags jscFlags(uint flags)
 {
     JSC::RegExpFlags jscFlags = JSC::NoFlags;
@@ -61,14 +65,82 @@ static JSC::RegExpFlags jscFlags(uint flags)
     return jscFlags;
 }
 
+// Patterns without any special characters are matched with a plain string search.
+static bool isLiteralPattern(const QString &pattern, uint flags)
+{
+    // Case folding and surrogate pair handling differ from QString's, and sticky patterns
+    // must only match at the start offset.
+    if (pattern.isEmpty() || (flags & (CompiledData::RegExp::RegExp_IgnoreCase
+                                       | CompiledData::RegExp::RegExp_Unicode
+                                       | CompiledData::RegExp::RegExp_Sticky))) {
+        return false;
+    }
+
+    for (QChar ch : pattern) {
+        switch (ch.unicode()) {
+        case '\\': case '^': case '$': case '.': case '|': case '?': case '*': case '+':
+        case '(': case ')': case '[': case ']': case '{': case '}':
+            return false;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+#if ENABLE(YARR_JIT)
+static const char *jitFailureReason(JSC::Yarr::YarrCodeBlock *jitCode)
+{
+    if (!jitCode)
+        return "back references are not supported";
+    if (!jitCode->failureReason().has_value())
+        return "no 16 bit code generated";
+
+    switch (*jitCode->failureReason()) {
+    case JSC::Yarr::JITFailureReason::DecodeSurrogatePair:
+        return "surrogate pair decoding";
+    case JSC::Yarr::JITFailureReason::BackReference:
+        return "back reference";
+    case JSC::Yarr::JITFailureReason::ForwardReference:
+        return "forward reference";
+    case JSC::Yarr::JITFailureReason::VariableCountedParenthesisWithNonZeroMinimum:
+        return "variable counted parenthesis with non-zero minimum";
+    case JSC::Yarr::JITFailureReason::ParenthesizedSubpattern:
+        return "parenthesized subpattern";
+    case JSC::Yarr::JITFailureReason::FixedCountParenthesizedSubpattern:
+        return "fixed count parenthesized subpattern";
+    case JSC::Yarr::JITFailureReason::ExecutableMemoryAllocationFailure:
+        return "executable memory allocation failure";
+    }
+    return "unknown";
+}
+#endif
+
 RegExpCache::~RegExpCache()
 {
+    dumpStats();
     for (RegExpCache::Iterator it = begin(), e = end(); it != e; ++it) {
         if (RegExp *re = it.value().as<RegExp>())
             re->d()->cache = nullptr;
     }
 }
 
+void RegExpCache::dumpStats() const
+{
+    const QLoggingCategory &stats = lcRegExpStats();
+    if (!stats.isDebugEnabled())
+        return;
+
+    qDebug(stats) << "Regular expression statistics:";
+    qDebug(stats) << "Patterns matched as literal strings:" << statistics.literalPatterns;
+    qDebug(stats) << "Patterns compiled by the JIT:" << statistics.jitPatterns;
+    qDebug(stats) << "Patterns compiled for the interpreter:" << statistics.interpretedPatterns;
+    qDebug(stats) << "Literal string matches:" << statistics.literalMatches;
+    qDebug(stats) << "JIT matches:" << statistics.jitMatches;
+    qDebug(stats) << "JIT matches falling back to the interpreter:" << statistics.jitFallbacks;
+    qDebug(stats) << "Interpreter matches:" << statistics.interpretedMatches;
+}
+
 DEFINE_MANAGED_VTABLE(RegExp);
 
 uint RegExp::match(const QString &string, int start, uint *matchOffsets)
@@ -76,11 +148,23 @@ uint RegExp::match(const QString &string, int start, uint *matchOffsets)
     if (!isValid())
         return JSC::Yarr::offsetNoMatch;
 
+    auto *priv = d();
+    RegExpCache *cache = priv->cache;
+    if (priv->literal) {
+        if (cache)
+            ++cache->statistics.literalMatches;
+        const int index = string.indexOf(*priv->pattern, start);
+        if (index < 0)
+            return JSC::Yarr::offsetNoMatch;
+        matchOffsets[0] = uint(index);
+        matchOffsets[1] = uint(index + priv->pattern->length());
+        return uint(index);
+    }
+
     WTF::String s(string);
 
 #if ENABLE(YARR_JIT)
     static const uint offsetJITFail = std::numeric_limits<unsigned>::max() - 1;
-    auto *priv = d();
     if (priv->hasValidJITCode()) {
         uint ret = JSC::Yarr::offsetNoMatch;
 #if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
@@ -91,8 +175,14 @@ uint RegExp::match(const QString &string, int start, uint *matchOffsets)
         ret = uint(priv->jitCode->execute(s.characters16(), start, s.length(),
                                           (int*)matchOffsets).start);
 #endif
-        if (ret != offsetJITFail)
+        if (ret != offsetJITFail) {
+            if (cache)
+                ++cache->statistics.jitMatches;
             return ret;
+        }
+
+        if (cache)
+            ++cache->statistics.jitFallbacks;
 
         // JIT failed. We need byteCode to run the interpreter.
         if (!priv->byteCode) {
@@ -110,6 +200,8 @@ uint RegExp::match(const QString &string, int start, uint *matchOffsets)
     }
 #endif // ENABLE(YARR_JIT)
 
+    if (cache)
+        ++cache->statistics.interpretedMatches;
     return JSC::Yarr::interpret(byteCode(), s.characters16(), string.length(), start, matchOffsets);
 }
 
@@ -211,6 +303,18 @@ void Heap::RegExp::init(ExecutionEngine *engine, const QString &pattern, uint fl
     this->flags = flags;
 
     valid = false;
+    literal = false;
+
+    RegExpCache *cache = engine->regExpCache;
+    if (isLiteralPattern(pattern, flags)) {
+        // No need to compile anything
+        subPatternCount = 0;
+        literal = true;
+        valid = true;
+        if (cache)
+            ++cache->statistics.literalPatterns;
+        return;
+    }
 
     JSC::Yarr::ErrorCode error = JSC::Yarr::ErrorCode::NoError;
     JSC::Yarr::YarrPattern yarrPattern(WTF::String(pattern), jscFlags(flags), error);
@@ -223,16 +327,23 @@ void Heap::RegExp::init(ExecutionEngine *engine, const QString &pattern, uint fl
         JSC::VM *vm = static_cast<JSC::VM *>(engine);
         JSC::Yarr::jitCompile(yarrPattern, JSC::Yarr::Char16, vm, *jitCode);
     }
-#else
-    Q_UNUSED(engine)
 #endif
     if (hasValidJITCode()) {
         valid = true;
+        if (cache)
+            ++cache->statistics.jitPatterns;
         return;
     }
+#if ENABLE(YARR_JIT)
+    if (engine->canJIT())
+        qCDebug(lcRegExpStats) << "Interpreting" << pattern << "because of" << jitFailureReason(jitCode);
+#endif
     byteCode = JSC::Yarr::byteCompile(yarrPattern, internalClass->engine->bumperPointerAllocator).release();
-    if (byteCode)
+    if (byteCode) {
         valid = true;
+        if (cache)
+            ++cache->statistics.interpretedPatterns;
+    }
 }
 
 void Heap::RegExp::destroy()
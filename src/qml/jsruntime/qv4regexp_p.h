@@ -102,6 +102,7 @@ struct RegExp : Base {
     int subPatternCount;
     uint flags;
     bool valid;
+    bool literal;
 
     QString flagsAsString() const;
     int captureCount() const { return subPatternCount + 1; }
@@ -171,6 +172,18 @@ class RegExpCache : public QHash<RegExpCacheKey, WeakValue>
 {
 public:
     ~RegExpCache();
+
+    void dumpStats() const;
+
+    struct {
+        uint literalPatterns = 0;
+        uint jitPatterns = 0;
+        uint interpretedPatterns = 0;
+        quint64 literalMatches = 0;
+        quint64 jitMatches = 0;
+        quint64 jitFallbacks = 0;
+        quint64 interpretedMatches = 0;
+    } statistics;
 };
 
 
@@ -317,7 +317,7 @@ void RuntimeHelpers::numberToString(QString *result, double num, int radix)
 ReturnedValue Runtime::Closure::call(ExecutionEngine *engine, int functionId)
 {
     QV4::Function *clos = engine->currentStackFrame->v4Function->executableCompilationUnit()
-                                  ->runtimeFunctions[functionId];
+                                  ->runtimeFunctionAt(functionId);
     Q_ASSERT(clos);
     ExecutionContext *current = static_cast<ExecutionContext *>(&engine->currentStackFrame->jsFrame->context);
     if (clos->isGenerator())
@@ -626,6 +626,8 @@ QV4::ReturnedValue RuntimeHelpers::addHelper(ExecutionEngine *engine, const Valu
             return sright->asReturnedValue();
         if (!sright->d()->length())
             return sleft->asReturnedValue();
+        if (sleft->d()->length() > Heap::String::MaxLength - sright->d()->length())
+            return engine->throwRangeError(QStringLiteral("Invalid string length."));
         MemoryManager *mm = engine->memoryManager;
         return (mm->alloc<ComplexString>(sleft->d(), sright->d()))->asReturnedValue();
     }
@@ -1746,7 +1748,7 @@ ReturnedValue Runtime::ArrayLiteral::call(ExecutionEngine *engine, Value *values
 ReturnedValue Runtime::ObjectLiteral::call(ExecutionEngine *engine, int classId, QV4::Value args[], int argc)
 {
     Scope scope(engine);
-    Scoped<InternalClass> klass(scope, engine->currentStackFrame->v4Function->compilationUnit->runtimeClasses[classId]);
+    Scoped<InternalClass> klass(scope, engine->currentStackFrame->v4Function->executableCompilationUnit()->runtimeClassAt(classId));
     ScopedObject o(scope, engine->newObject(klass->d()));
 
     Q_ASSERT(uint(argc) >= klass->d()->size);
@@ -1776,7 +1778,7 @@ ReturnedValue Runtime::ObjectLiteral::call(ExecutionEngine *engine, int classId,
             Q_ASSERT(args[2].isInteger());
             int functionId = args[2].integerValue();
             QV4::Function *clos = engine->currentStackFrame->v4Function->executableCompilationUnit()
-                                          ->runtimeFunctions[functionId];
+                                          ->runtimeFunctionAt(functionId);
             Q_ASSERT(clos);
 
             PropertyKey::FunctionNamePrefix prefix = PropertyKey::None;
@@ -1849,7 +1851,7 @@ ReturnedValue Runtime::CreateClass::call(ExecutionEngine *engine, int classIndex
     ExecutionContext *current = static_cast<ExecutionContext *>(&engine->currentStackFrame->jsFrame->context);
 
     ScopedFunctionObject constructor(scope);
-    QV4::Function *f = cls->constructorFunction != UINT_MAX ? unit->runtimeFunctions[cls->constructorFunction] : nullptr;
+    QV4::Function *f = cls->constructorFunction != UINT_MAX ? unit->runtimeFunctionAt(cls->constructorFunction) : nullptr;
     constructor = FunctionObject::createConstructorFunction(current, f, proto, !superClass.isEmpty())->asReturnedValue();
     constructor->setPrototypeUnchecked(constructorParent);
     Value argCount = Value::fromInt32(f ? f->nFormals : 0);
@@ -1882,7 +1884,7 @@ ReturnedValue Runtime::CreateClass::call(ExecutionEngine *engine, int classIndex
             name = unit->runtimeStrings[methods[i].name];
             propertyName = name->toPropertyKey();
         }
-        QV4::Function *f = unit->runtimeFunctions[methods[i].function];
+        QV4::Function *f = unit->runtimeFunctionAt(methods[i].function);
         Q_ASSERT(f);
         PropertyKey::FunctionNamePrefix prefix = PropertyKey::None;
         if (methods[i].type == CompiledData::Method::Getter)
@@ -1945,9 +1947,10 @@ QV4::ReturnedValue Runtime::CreateRestParameter::call(ExecutionEngine *engine, i
 
 ReturnedValue Runtime::RegexpLiteral::call(ExecutionEngine *engine, int id)
 {
-    const auto val
-            = engine->currentStackFrame->v4Function->compilationUnit->runtimeRegularExpressions[id];
-    Heap::RegExpObject *ro = engine->newRegExpObject(Value::fromStaticValue(val).as<RegExp>());
+    Scope scope(engine);
+    Scoped<RegExp> re(scope, engine->currentStackFrame->v4Function->executableCompilationUnit()
+                                     ->runtimeRegularExpressionAt(id));
+    Heap::RegExpObject *ro = engine->newRegExpObject(re);
     return ro->asReturnedValue();
 }
 
@@ -170,68 +170,157 @@ void String::createPropertyKeyImpl() const
     engine()->identifierTable->asPropertyKey(this);
 }
 
+// Visits the leaves of a rope together with their position in the flattened string. Leaves are
+// visited as soon as they are found, so only nodes with ropes on both sides need to be remembered.
+// Linear ropes, as built by appending or prepending in a loop, are walked without extra memory.
+template <typename Visitor>
+static bool forEachLeaf(const Heap::String *string, Visitor visit)
+{
+    std::vector<std::pair<const Heap::String *, int>> worklist;
+    int offset = 0;
+
+    for (;;) {
+        while (string->subtype == Heap::String::StringType_AddedString) {
+            const Heap::ComplexString *cs = static_cast<const Heap::ComplexString *>(string);
+            const int rightOffset = offset + cs->left->length();
+            if (cs->right->subtype != Heap::String::StringType_AddedString) {
+                if (!visit(cs->right, rightOffset))
+                    return false;
+                string = cs->left;
+            } else if (cs->left->subtype != Heap::String::StringType_AddedString) {
+                if (!visit(cs->left, offset))
+                    return false;
+                string = cs->right;
+                offset = rightOffset;
+            } else {
+                worklist.push_back(std::make_pair(cs->right, rightOffset));
+                string = cs->left;
+            }
+        }
+        if (!visit(string, offset))
+            return false;
+        if (worklist.empty())
+            return true;
+        string = worklist.back().first;
+        offset = worklist.back().second;
+        worklist.pop_back();
+    }
+}
+
+// Returns the leftmost leaf of this rope if we can take over its buffer and append the rest of
+// the rope to it. That makes building a string piece by piece, while also looking at the
+// intermediate results, amortized linear instead of quadratic.
+const Heap::String *Heap::String::appendableLeaf() const
+{
+    if (subtype != StringType_AddedString)
+        return nullptr;
+
+    const String *leaf = this;
+    while (leaf->subtype == StringType_AddedString)
+        leaf = static_cast<const ComplexString *>(leaf)->left;
+
+    if (leaf->subtype != StringType_Flattened || leaf->identifier.isValid()
+            || leaf->text->ref.isShared()) {
+        return nullptr;
+    }
+
+    // The leaf loses its buffer, so nothing else in the rope may read from it.
+    bool seen = false;
+    return forEachLeaf(this, [leaf, &seen](const String *item, int) {
+        if (item == leaf) {
+            if (seen)
+                return false;
+            seen = true;
+            return true;
+        }
+        return item->subtype < StringType_Complex;
+    }) ? leaf : nullptr;
+}
+
 void Heap::String::simplifyString() const
 {
     Q_ASSERT(!text);
 
     int l = length();
-    QString result(l, Qt::Uninitialized);
+    const String *leaf = appendableLeaf();
+    const int leafLength = leaf ? leaf->text->size : 0;
+
+    QString result;
+    if (leaf) {
+        // Take over the reference held by the leaf. Growing the buffer reserves extra space
+        // for further appends.
+        QStringDataPtr ptr = { leaf->text };
+        result = QString(ptr);
+        result.resize(l);
+
+        // The leaf's contents stay at the start of our buffer
+        ComplexString *substring = static_cast<ComplexString *>(const_cast<String *>(leaf));
+        substring->text = nullptr;
+        substring->subtype = StringType_SubString;
+        substring->left = const_cast<String *>(this);
+        substring->right = nullptr;
+        substring->from = 0;
+        substring->len = leafLength;
+    } else {
+        result = QString(l, Qt::Uninitialized);
+    }
     QChar *ch = const_cast<QChar *>(result.constData());
-    append(this, ch);
+    append(this, ch, leaf);
     text = result.data_ptr();
     text->ref.ref();
     const ComplexString *cs = static_cast<const ComplexString *>(this);
     identifier = PropertyKey::invalid();
     cs->left = cs->right = nullptr;
 
-    internalClass->engine->memoryManager->changeUnmanagedHeapSizeUsage(qptrdiff(text->size) * (qptrdiff)sizeof(QChar));
-    subtype = StringType_Unknown;
+    internalClass->engine->memoryManager->changeUnmanagedHeapSizeUsage(qptrdiff(text->size - leafLength) * (qptrdiff)sizeof(QChar));
+    subtype = StringType_Flattened;
 }
 
 bool Heap::String::startsWithUpper() const
 {
-    if (subtype == StringType_AddedString)
-        return static_cast<const Heap::ComplexString *>(this)->left->startsWithUpper();
-
     const Heap::String *str = this;
     int offset = 0;
-    if (subtype == StringType_SubString) {
-        const ComplexString *cs = static_cast<const Heap::ComplexString *>(this);
-        if (!cs->len)
-            return false;
-        // simplification here is not ideal, but hopefully not a common case.
-        if (cs->left->subtype >= Heap::String::StringType_Complex)
-            cs->left->simplifyString();
-        str = cs->left;
-        offset = cs->from;
+    while (str->subtype >= Heap::String::StringType_Complex) {
+        const ComplexString *cs = static_cast<const Heap::ComplexString *>(str);
+        if (cs->subtype == StringType_AddedString) {
+            const int leftLength = cs->left->length();
+            if (offset < leftLength) {
+                str = cs->left;
+            } else {
+                offset -= leftLength;
+                str = cs->right;
+            }
+        } else {
+            if (!cs->len)
+                return false;
+            offset += cs->from;
+            str = cs->left;
+        }
     }
-    Q_ASSERT(str->subtype < Heap::String::StringType_Complex);
     return str->text->size > offset && QChar::isUpper(str->text->data()[offset]);
 }
 
-void Heap::String::append(const String *data, QChar *ch)
+void Heap::String::append(const String *data, QChar *ch, const String *skip)
 {
-    std::vector<const String *> worklist;
-    worklist.reserve(32);
-    worklist.push_back(data);
-
-    while (!worklist.empty()) {
-        const String *item = worklist.back();
-        worklist.pop_back();
+    forEachLeaf(data, [ch, skip](const String *item, int offset) {
+        if (item == skip)
+            return true;
 
-        if (item->subtype == StringType_AddedString) {
+        if (item->subtype == StringType_SubString) {
             const ComplexString *cs = static_cast<const ComplexString *>(item);
-            worklist.push_back(cs->right);
-            worklist.push_back(cs->left);
-        } else if (item->subtype == StringType_SubString) {
-            const ComplexString *cs = static_cast<const ComplexString *>(item);
-            memcpy(ch, cs->left->toQString().constData() + cs->from, cs->len*sizeof(QChar));
-            ch += cs->len;
+            const String *source = cs->left;
+            int from = cs->from;
+            while (source->subtype == StringType_SubString) {
+                const ComplexString *sourceSubString = static_cast<const ComplexString *>(source);
+                from += sourceSubString->from;
+                source = sourceSubString->left;
+            }
+            memcpy(static_cast<void *>(ch + offset), source->toQString().constData() + from, cs->len*sizeof(QChar));
         } else {
-            memcpy(static_cast<void *>(ch), static_cast<const void *>(item->text->data()), item->text->size * sizeof(QChar));
-            ch += item->text->size;
+            memcpy(static_cast<void *>(ch + offset), static_cast<const void *>(item->text->data()), item->text->size * sizeof(QChar));
         }
-    }
+        return true;
+    });
 }
 
 void Heap::StringOrSymbol::createHashValue() const
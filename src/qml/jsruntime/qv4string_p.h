@@ -72,6 +72,9 @@ struct Q_QML_PRIVATE_EXPORT StringOrSymbol : Base
         StringType_Regular,
         StringType_ArrayIndex,
         StringType_Unknown,
+        // A string that was flattened from a rope. Its buffer can be taken over when the
+        // string is the leftmost part of another rope that gets flattened.
+        StringType_Flattened,
         StringType_AddedString,
         StringType_SubString,
         StringType_Complex = StringType_AddedString
@@ -125,6 +128,13 @@ struct Q_QML_PRIVATE_EXPORT String : StringOrSymbol {
     inline bool isEqualTo(const String *other) const {
         if (this == other)
             return true;
+        if (length() != other->length())
+            return false;
+        // Comparing large strings directly is cheaper than hashing them first
+        if (length() >= LargeStringLength
+                && (subtype >= StringType_Unknown || other->subtype >= StringType_Unknown)) {
+            return toQString() == other->toQString();
+        }
         if (hashValue() != other->hashValue())
             return false;
         Q_ASSERT(subtype < StringType_Complex);
@@ -138,8 +148,14 @@ struct Q_QML_PRIVATE_EXPORT String : StringOrSymbol {
 
     bool startsWithUpper() const;
 
+    enum {
+        LargeStringLength = 1024,
+        MaxLength = (std::numeric_limits<int>::max() - int(sizeof(QStringData))) / int(sizeof(QChar)) - 1
+    };
+
 private:
-    static void append(const String *data, QChar *ch);
+    const String *appendableLeaf() const;
+    static void append(const String *data, QChar *ch, const String *skip = nullptr);
 };
 Q_STATIC_ASSERT(std::is_trivial< String >::value);
 
@@ -46,7 +46,11 @@
 #include "qv4runtime_p.h"
 #include <QtCore/qatomic.h>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 using namespace QV4;
 
@@ -227,6 +231,105 @@ ReturnedValue atomicStore(char *data, Value v)
     return typeToValue(value);
 }
 
+// Elements of a Uint8ClampedArray are stored as plain bytes. The bulk operations below work
+// directly on the storage type so that the loops stay simple enough for the compiler to vectorize.
+template <typename T>
+struct StorageType { typedef T Type; };
+
+template <>
+struct StorageType<ClampedUInt8> { typedef quint8 Type; };
+
+template <typename T>
+void fill(char *data, uint from, uint to, Value value)
+{
+    T *elements = reinterpret_cast<T *>(data);
+    std::fill(elements + from, elements + to, valueToType<T>(value));
+}
+
+template <typename S>
+static bool toStorage(double d, S *result, std::true_type /* integral */)
+{
+    if (!(d >= double(std::numeric_limits<S>::min()) && d <= double(std::numeric_limits<S>::max())))
+        return false;
+    *result = static_cast<S>(d);
+    return double(*result) == d;
+}
+
+template <typename S>
+static bool toStorage(double d, S *result, std::false_type /* floating point */)
+{
+    // Converting finite values outside the range of S is undefined, and S can't hold them anyway
+    if (!std::isinf(d) && !(d >= double(std::numeric_limits<S>::lowest()) && d <= double(std::numeric_limits<S>::max())))
+        return false;
+    *result = static_cast<S>(d);
+    return double(*result) == d;
+}
+
+template <typename T>
+uint indexOf(const char *data, uint from, uint to, Value value, bool sameValueZero)
+{
+    typedef typename StorageType<T>::Type S;
+    const S *elements = reinterpret_cast<const S *>(data);
+    if (!value.isNumber())
+        return UINT_MAX;
+
+    const double d = toDouble(value);
+    if (std::isnan(d)) {
+        // Only floating point arrays can contain NaN, and only includes() finds it
+        if (!sameValueZero || std::is_integral<S>::value)
+            return UINT_MAX;
+        for (uint i = from; i < to; ++i) {
+            if (std::isnan(double(elements[i])))
+                return i;
+        }
+        return UINT_MAX;
+    }
+
+    S s;
+    if (!toStorage(d, &s, std::is_integral<S>()))
+        return UINT_MAX;
+    for (uint i = from; i < to; ++i) {
+        if (elements[i] == s)
+            return i;
+    }
+    return UINT_MAX;
+}
+
+template <typename T>
+void reverse(char *data, uint length)
+{
+    typedef typename StorageType<T>::Type S;
+    S *elements = reinterpret_cast<S *>(data);
+    std::reverse(elements, elements + length);
+}
+
+template <typename S>
+static void sortElements(S *elements, uint length, std::true_type /* integral */)
+{
+    std::sort(elements, elements + length);
+}
+
+template <typename S>
+static void sortElements(S *elements, uint length, std::false_type /* floating point */)
+{
+    // NaN sorts after everything else, and -0 before +0
+    std::sort(elements, elements + length, [](S a, S b) {
+        if (std::isnan(b))
+            return !std::isnan(a);
+        if (std::isnan(a))
+            return false;
+        if (a == 0 && b == 0)
+            return std::signbit(a) && !std::signbit(b);
+        return a < b;
+    });
+}
+
+template <typename T>
+void sort(char *data, uint length)
+{
+    typedef typename StorageType<T>::Type S;
+    sortElements(reinterpret_cast<S *>(data), length, std::is_integral<S>());
+}
 
 template<typename T>
 constexpr TypedArrayOperations TypedArrayOperations::create(const char *name)
@@ -238,7 +341,11 @@ constexpr TypedArrayOperations TypedArrayOperations::create(const char *name)
              { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr },
              nullptr,
              nullptr,
-             nullptr
+             nullptr,
+             ::fill<T>,
+             ::indexOf<T>,
+             ::reverse<T>,
+             ::sort<T>
     };
 }
 
@@ -252,7 +359,11 @@ constexpr TypedArrayOperations TypedArrayOperations::createWithAtomics(const cha
              { ::atomicAdd<T>, ::atomicAnd<T>, ::atomicExchange<T>, ::atomicOr<T>, ::atomicSub<T>, ::atomicXor<T> },
              ::atomicCompareExchange<T>,
              ::atomicLoad<T>,
-             ::atomicStore<T>
+             ::atomicStore<T>,
+             ::fill<T>,
+             ::indexOf<T>,
+             ::reverse<T>,
+             ::sort<T>
     };
 }
 
@@ -803,14 +914,8 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_fill(const FunctionObject *b,
     if (scope.hasException() || v->d()->buffer->isDetachedBuffer())
         return scope.engine->throwTypeError();
 
-    char *data = v->d()->buffer->data->data();
-    uint bytesPerElement = v->d()->type->bytesPerElement;
-    uint byteOffset = v->d()->byteOffset;
-
-    while (k < fin) {
-        v->d()->type->write(data + byteOffset + k * bytesPerElement, value);
-        k++;
-    }
+    if (k < fin)
+        v->d()->type->fill(v->d()->buffer->data->data() + v->d()->byteOffset, k, fin, value);
 
     return v.asReturnedValue();
 }
@@ -1000,6 +1105,7 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_includes(const FunctionObject
     double n = 0;
     if (argc > 1 && !argv[1].isUndefined()) {
         n = argv[1].toInteger();
+        CHECK_EXCEPTION();
     }
 
     double k = 0;
@@ -1012,15 +1118,12 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_includes(const FunctionObject
         }
     }
 
-    while (k < len) {
-        ScopedValue val(scope, v->get(k));
-        if (val->sameValueZero(argv[0])) {
-            return Encode(true);
-        }
-        k++;
-    }
+    if (k >= len || v->d()->buffer->isDetachedBuffer())
+        return Encode(false);
 
-    return Encode(false);
+    const char *data = v->d()->buffer->data->data() + v->d()->byteOffset;
+    Value searchValue = argc ? argv[0] : Value::undefinedValue();
+    return Encode(v->d()->type->indexOf(data, uint(k), len, searchValue, true) != UINT_MAX);
 }
 
 ReturnedValue IntrinsicTypedArrayPrototype::method_indexOf(const FunctionObject *b, const Value *thisObject, const Value *argv, int argc)
@@ -1047,27 +1150,12 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_indexOf(const FunctionObject
         fromIndex = (uint) f;
     }
 
-    if (v->isStringObject()) {
-        ScopedValue value(scope);
-        for (uint k = fromIndex; k < len; ++k) {
-            bool exists;
-            value = v->get(k, &exists);
-            if (exists && RuntimeHelpers::strictEqual(value, searchValue))
-                return Encode(k);
-        }
+    if (v->d()->buffer->isDetachedBuffer())
         return Encode(-1);
-    }
-
-    ScopedValue value(scope);
 
-    for (uint i = fromIndex; i < len; ++i) {
-        bool exists;
-        value = v->get(i, &exists);
-        CHECK_EXCEPTION();
-        if (exists && RuntimeHelpers::strictEqual(value, searchValue))
-            return Encode(i);
-    }
-    return Encode(-1);
+    const char *data = v->d()->buffer->data->data() + v->d()->byteOffset;
+    uint index = v->d()->type->indexOf(data, fromIndex, len, *searchValue, false);
+    return index == UINT_MAX ? Encode(-1) : Encode(index);
 }
 
 ReturnedValue IntrinsicTypedArrayPrototype::method_join(
@@ -1316,23 +1404,8 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_reverse(const FunctionObject
     if (!instance || instance->d()->buffer->isDetachedBuffer())
         return scope.engine->throwTypeError();
 
-    uint length = instance->length();
-
-    int lo = 0, hi = length - 1;
-
-    ScopedValue lval(scope);
-    ScopedValue hval(scope);
-    for (; lo < hi; ++lo, --hi) {
-        bool loExists, hiExists;
-        lval = instance->get(lo, &loExists);
-        hval = instance->get(hi, &hiExists);
-        Q_ASSERT(hiExists && loExists);
-        bool ok;
-        ok = instance->put(lo, hval);
-        Q_ASSERT(ok);
-        ok = instance->put(hi, lval);
-        Q_ASSERT(ok);
-    }
+    instance->d()->type->reverse(instance->d()->buffer->data->data() + instance->d()->byteOffset,
+                                 instance->length());
     return instance->asReturnedValue();
 }
 
@@ -1372,6 +1445,98 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_some(const FunctionObject *b,
 }
 
 
+namespace {
+// Stable merge sort calling a user supplied comparison function. The function can run arbitrary
+// code, so we sort a copy of the elements and stop as soon as it throws or detaches the buffer.
+struct TypedArrayElementLessThan
+{
+    ExecutionEngine *engine;
+    const FunctionObject *comparefn;
+    const TypedArray *instance;
+
+    bool operator()(Value v1, Value v2) const
+    {
+        if (engine->hasException)
+            return false;
+        Scope scope(engine);
+        ScopedValue result(scope);
+        JSCallData jsCallData(scope, 2);
+        jsCallData->args[0] = v1;
+        jsCallData->args[1] = v2;
+        result = comparefn->call(jsCallData);
+        if (scope.hasException())
+            return false;
+        double v = result->toNumber();
+        if (scope.hasException())
+            return false;
+        if (instance->d()->buffer->isDetachedBuffer()) {
+            engine->throwTypeError();
+            return false;
+        }
+        return v < 0;
+    }
+};
+
+void mergeSort(Value *values, Value *buffer, uint length, const TypedArrayElementLessThan &lessThan)
+{
+    if (length < 2)
+        return;
+    const uint middle = length / 2;
+    mergeSort(values, buffer, middle, lessThan);
+    mergeSort(values + middle, buffer, length - middle, lessThan);
+
+    uint i = 0, j = middle, k = 0;
+    while (i < middle && j < length) {
+        if (lessThan(values[j], values[i]))
+            buffer[k++] = values[j++];
+        else
+            buffer[k++] = values[i++];
+    }
+    while (i < middle)
+        buffer[k++] = values[i++];
+    // The remaining elements of the right half are already in place
+    std::copy(buffer, buffer + k, values);
+}
+}
+
+ReturnedValue IntrinsicTypedArrayPrototype::method_sort(const FunctionObject *b, const Value *thisObject, const Value *argv, int argc)
+{
+    Scope scope(b);
+    const Value comparefn = argc ? argv[0] : Value::undefinedValue();
+    if (!comparefn.isUndefined() && !comparefn.isFunctionObject())
+        return scope.engine->throwTypeError();
+
+    Scoped<TypedArray> instance(scope, thisObject);
+    if (!instance || instance->d()->buffer->isDetachedBuffer())
+        return scope.engine->throwTypeError();
+
+    uint length = instance->length();
+    if (length < 2)
+        return instance->asReturnedValue();
+
+    const TypedArrayOperations *type = instance->d()->type;
+    if (comparefn.isUndefined()) {
+        type->sort(instance->d()->buffer->data->data() + instance->d()->byteOffset, length);
+        return instance->asReturnedValue();
+    }
+
+    // All elements are numbers, so they don't need to be protected from the GC.
+    std::vector<Value> values(length);
+    const char *data = instance->d()->buffer->data->data() + instance->d()->byteOffset;
+    for (uint i = 0; i < length; ++i)
+        values[i] = Value::fromReturnedValue(type->read(data + i * type->bytesPerElement));
+
+    std::vector<Value> buffer(length);
+    TypedArrayElementLessThan lessThan{ scope.engine, static_cast<const FunctionObject *>(&comparefn), instance };
+    mergeSort(values.data(), buffer.data(), length, lessThan);
+    CHECK_EXCEPTION();
+
+    char *out = instance->d()->buffer->data->data() + instance->d()->byteOffset;
+    for (uint i = 0; i < length; ++i)
+        type->write(out + i * type->bytesPerElement, values[i]);
+    return instance->asReturnedValue();
+}
+
 ReturnedValue IntrinsicTypedArrayPrototype::method_values(const FunctionObject *b, const Value *thisObject, const Value *, int)
 {
     Scope scope(b);
@@ -1838,6 +2003,7 @@ void IntrinsicTypedArrayPrototype::init(ExecutionEngine *engine, IntrinsicTypedA
     defineDefaultProperty(QStringLiteral("reduceRight"), method_reduceRight, 1);
     defineDefaultProperty(QStringLiteral("reverse"), method_reverse, 0);
     defineDefaultProperty(QStringLiteral("some"), method_some, 1);
+    defineDefaultProperty(QStringLiteral("sort"), method_sort, 1);
     defineDefaultProperty(QStringLiteral("set"), method_set, 1);
     defineDefaultProperty(QStringLiteral("slice"), method_slice, 2);
     defineDefaultProperty(QStringLiteral("subarray"), method_subarray, 2);
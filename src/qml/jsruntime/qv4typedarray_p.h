@@ -90,6 +90,10 @@ struct TypedArrayOperations {
     typedef ReturnedValue (*AtomicCompareExchange)(char *data, Value expected, Value v);
     typedef ReturnedValue (*AtomicLoad)(char *data);
     typedef ReturnedValue (*AtomicStore)(char *data, Value value);
+    typedef void (*Fill)(char *data, uint from, uint to, Value value);
+    typedef uint (*IndexOf)(const char *data, uint from, uint to, Value value, bool sameValueZero);
+    typedef void (*Reverse)(char *data, uint length);
+    typedef void (*Sort)(char *data, uint length);
 
     template<typename T>
     static constexpr TypedArrayOperations create(const char *name);
@@ -104,6 +108,10 @@ struct TypedArrayOperations {
     AtomicCompareExchange atomicCompareExchange;
     AtomicLoad atomicLoad;
     AtomicStore atomicStore;
+    Fill fill;
+    IndexOf indexOf;
+    Reverse reverse;
+    Sort sort;
 };
 
 namespace Heap {
@@ -222,6 +230,7 @@ struct IntrinsicTypedArrayPrototype : Object
     static ReturnedValue method_reduceRight(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_reverse(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_some(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
+    static ReturnedValue method_sort(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_values(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_set(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_slice(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
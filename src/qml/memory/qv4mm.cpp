@@ -53,9 +53,16 @@
 #include "PageAllocationAligned.h"
 #include "StdLibExtras.h"
 
+#include <QDeadlineTimer>
 #include <QElapsedTimer>
 #include <QMap>
 #include <QScopedValueRollback>
+#if QT_CONFIG(thread)
+#include <QMutex>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+#endif
 
 #include <iostream>
 #include <cstdlib>
@@ -304,7 +311,7 @@ static void increaseFreedCountForClass(const char *className)
 }
 
 //bool Chunk::sweep(ClassDestroyStatsCallback classCountPtr)
-bool Chunk::sweep(ExecutionEngine *engine)
+bool Chunk::sweep(ExecutionEngine *engine, bool destroyItems)
 {
     bool hasUsedSlots = false;
     SDUMP() << "sweeping chunk" << this;
@@ -341,21 +348,25 @@ bool Chunk::sweep(ExecutionEngine *engine)
             e &= result;
 
             HeapItem *itemToFree = o + index;
-            Heap::Base *b = *itemToFree;
-            const VTable *v = b->internalClass->vtable;
-//            if (Q_UNLIKELY(classCountPtr))
-//                classCountPtr(v->className);
-            if (v->destroy) {
-                v->destroy(b);
-                b->_checkIsDestroyed();
+            if (destroyItems) {
+                Heap::Base *b = *itemToFree;
+                const VTable *v = b->internalClass->vtable;
+//                if (Q_UNLIKELY(classCountPtr))
+//                    classCountPtr(v->className);
+                if (v->destroy) {
+                    v->destroy(b);
+                    b->_checkIsDestroyed();
+                }
             }
 #ifdef V4_USE_HEAPTRACK
             heaptrack_report_free(itemToFree);
 #endif
         }
-        Q_V4_PROFILE_DEALLOC(engine, qPopulationCount((objectBitmap[i] | extendsBitmap[i])
-                                                      - (blackBitmap[i] | e)) * Chunk::SlotSize,
-                             Profiling::SmallItem);
+        if (engine) {
+            Q_V4_PROFILE_DEALLOC(engine, qPopulationCount((objectBitmap[i] | extendsBitmap[i])
+                                                          - (blackBitmap[i] | e)) * Chunk::SlotSize,
+                                 Profiling::SmallItem);
+        }
         objectBitmap[i] = blackBitmap[i];
         grayBitmap[i] = 0;
         hasUsedSlots |= (blackBitmap[i] != 0);
@@ -449,6 +460,42 @@ void Chunk::collectGrayItems(MarkStack *markStack)
 
 }
 
+void Chunk::detachUnmarkedInternalClasses()
+{
+    HeapItem *o = realBase();
+    for (uint i = 0; i < Chunk::EntriesInBitmap; ++i) {
+        quintptr toDetach = objectBitmap[i] & ~blackBitmap[i];
+        while (toDetach) {
+            uint index = qCountTrailingZeroBits(toDetach);
+            toDetach ^= (static_cast<quintptr>(1) << index);
+
+            Heap::Base *b = o[index];
+            static_cast<Heap::InternalClass *>(b)->detachFromParent();
+        }
+        o += Chunk::Bits;
+    }
+}
+
+void Chunk::destroyUnmarkedItems()
+{
+    HeapItem *o = realBase();
+    for (uint i = 0; i < Chunk::EntriesInBitmap; ++i) {
+        quintptr toDestroy = objectBitmap[i] ^ blackBitmap[i];
+        while (toDestroy) {
+            uint index = qCountTrailingZeroBits(toDestroy);
+            toDestroy ^= (static_cast<quintptr>(1) << index);
+
+            Heap::Base *b = o[index];
+            const VTable *v = b->internalClass->vtable;
+            if (v->destroy) {
+                v->destroy(b);
+                b->_checkIsDestroyed();
+            }
+        }
+        o += Chunk::Bits;
+    }
+}
+
 void Chunk::sortIntoBins(HeapItem **bins, uint nBins)
 {
 //    qDebug() << "sortIntoBins:";
@@ -645,8 +692,231 @@ void BlockAllocator::sweep()
     chunks.erase(firstEmptyChunk, chunks.end());
 }
 
+void BlockAllocator::startIncrementalSweep()
+{
+    Q_ASSERT(chunksToSweep.empty());
+    nextFree = nullptr;
+    nFree = 0;
+    memset(freeBins, 0, sizeof(freeBins));
+
+    usedSlotsAfterLastSweep = 0;
+    chunksToSweep.swap(chunks);
+}
+
+#if QT_CONFIG(thread)
+// Sweeps the bitmaps and free lists of chunks whose unmarked items have already been destroyed
+// on the main thread. This doesn't run user code or touch the engine, so it can happen while the
+// main thread keeps running. The main thread takes back the swept chunks, and sweeps the chunks
+// the background thread hasn't started on itself if it can't wait for them.
+struct BackgroundSweeper : public QRunnable
+{
+    BackgroundSweeper() { setAutoDelete(false); }
+
+    void start(std::vector<BlockAllocator::SweepJob> &&jobs)
+    {
+        QMutexLocker locker(&mutex);
+        Q_ASSERT(!running && todo.empty() && done.empty());
+        todo = std::move(jobs);
+        running = true;
+        locker.unlock();
+        QThreadPool::globalInstance()->start(this);
+    }
+
+    void run() override
+    {
+        QMutexLocker locker(&mutex);
+        while (!todo.empty()) {
+            BlockAllocator::SweepJob job = todo.back();
+            todo.pop_back();
+            ++inFlight;
+            locker.unlock();
+
+            sweep(&job);
+
+            locker.relock();
+            --inFlight;
+            done.push_back(job);
+            condition.wakeAll();
+        }
+        running = false;
+        condition.wakeAll();
+    }
+
+    static void sweep(BlockAllocator::SweepJob *job)
+    {
+        memset(job->bins, 0, sizeof(job->bins));
+        memset(job->lastInBins, 0, sizeof(job->lastInBins));
+        job->usedSlotsAfter = 0;
+        job->hasUsedSlots = job->chunk->sweep(nullptr, /*destroyItems*/ false);
+        if (job->hasUsedSlots) {
+            job->chunk->sortIntoBins(job->bins, BlockAllocator::NumBins);
+            for (uint i = 0; i < BlockAllocator::NumBins; ++i) {
+                HeapItem *last = job->bins[i];
+                while (last && last->freeData.next)
+                    last = last->freeData.next;
+                job->lastInBins[i] = last;
+            }
+            job->usedSlotsAfter = job->chunk->nUsedSlots();
+        }
+        job->chunk->resetBlackBits();
+        job->swept = true;
+    }
+
+    // Returns a chunk swept in the background, or one that hasn't been looked at yet. Waits for
+    // the chunks currently being swept if there is nothing else left.
+    bool takeJob(BlockAllocator::SweepJob *job)
+    {
+        QMutexLocker locker(&mutex);
+        for (;;) {
+            if (!done.empty()) {
+                *job = done.back();
+                done.pop_back();
+                return true;
+            }
+            if (!todo.empty()) {
+                *job = todo.back();
+                todo.pop_back();
+                return true;
+            }
+            if (!inFlight)
+                return false;
+            condition.wait(&mutex);
+        }
+    }
+
+    void wait()
+    {
+        if (QThreadPool::globalInstance()->tryTake(this)) {
+            QMutexLocker locker(&mutex);
+            running = false;
+            return;
+        }
+        QMutexLocker locker(&mutex);
+        while (running)
+            condition.wait(&mutex);
+    }
+
+    QMutex mutex;
+    QWaitCondition condition;
+    std::vector<BlockAllocator::SweepJob> todo;
+    std::vector<BlockAllocator::SweepJob> done;
+    uint inFlight = 0;
+    bool running = false;
+};
+#else
+struct BackgroundSweeper {};
+#endif
+
+BlockAllocator::~BlockAllocator()
+{
+#if QT_CONFIG(thread)
+    if (backgroundSweeper)
+        backgroundSweeper->wait();
+#endif
+    delete backgroundSweeper;
+}
+
+void BlockAllocator::startBackgroundSweep()
+{
+#if QT_CONFIG(thread)
+    if (!backgroundSweeper)
+        backgroundSweeper = new BackgroundSweeper;
+    else
+        backgroundSweeper->wait(); // for the previous run to return
+
+    // destroy() methods can call into the engine and QML, so run them all here before handing
+    // the chunks over.
+    for (Chunk *c : chunksToSweep)
+        c->destroyUnmarkedItems();
+
+    std::vector<SweepJob> jobs;
+    jobs.reserve(chunksToSweep.size());
+    for (Chunk *c : chunksToSweep) {
+        SweepJob job;
+        job.chunk = c;
+        job.swept = false;
+        job.usedSlotsBefore = c->nUsedSlots();
+        slotsInBackgroundSweep += job.usedSlotsBefore;
+        jobs.push_back(job);
+    }
+    chunksInBackgroundSweep += chunksToSweep.size();
+    chunksToSweep.clear();
+    backgroundSweeper->start(std::move(jobs));
+#endif
+}
+
+void BlockAllocator::takeChunkFromBackgroundSweep()
+{
+#if QT_CONFIG(thread)
+    SweepJob job;
+    const bool hasJob = backgroundSweeper->takeJob(&job);
+    Q_ASSERT(hasJob);
+    Q_UNUSED(hasJob);
+    --chunksInBackgroundSweep;
+    slotsInBackgroundSweep -= job.usedSlotsBefore;
+
+    if (job.swept)
+        ++chunksSweptInBackground;
+    else
+        BackgroundSweeper::sweep(&job);
+
+    if (job.hasUsedSlots) {
+        for (uint i = 0; i < NumBins; ++i) {
+            if (!job.bins[i])
+                continue;
+            job.lastInBins[i]->freeData.next = freeBins[i];
+            freeBins[i] = job.bins[i];
+        }
+        usedSlotsAfterLastSweep += job.usedSlotsAfter;
+        chunks.push_back(job.chunk);
+    } else {
+        emptyChunks.push_back(job.chunk);
+    }
+#endif
+}
+
+bool BlockAllocator::sweepNextChunk()
+{
+    if (!chunksToSweep.empty()) {
+        Chunk *c = chunksToSweep.back();
+        chunksToSweep.pop_back();
+        if (c->sweep(engine)) {
+            c->sortIntoBins(freeBins, NumBins);
+            usedSlotsAfterLastSweep += c->nUsedSlots();
+            c->resetBlackBits();
+            chunks.push_back(c);
+        } else {
+            emptyChunks.push_back(c);
+        }
+    } else if (chunksInBackgroundSweep) {
+        takeChunkFromBackgroundSweep();
+    } else {
+        return false;
+    }
+
+    if (chunksToSweep.empty() && !chunksInBackgroundSweep) {
+        // as in sweep(), only free the empty chunks once everything has been destroyed
+        for (auto c : emptyChunks) {
+            Q_V4_PROFILE_DEALLOC(engine, Chunk::DataSize, Profiling::HeapPage);
+            chunkAllocator->free(c);
+        }
+        emptyChunks.clear();
+    }
+    return true;
+}
+
+void BlockAllocator::sweepPendingChunks()
+{
+    while (sweepNextChunk()) {}
+}
+
 void BlockAllocator::freeAll()
 {
+    chunks.insert(chunks.end(), chunksToSweep.begin(), chunksToSweep.end());
+    chunks.insert(chunks.end(), emptyChunks.begin(), emptyChunks.end());
+    chunksToSweep.clear();
+    emptyChunks.clear();
+
     for (auto c : chunks)
         c->freeAll(engine);
     for (auto c : chunks) {
@@ -770,10 +1040,19 @@ MemoryManager::MemoryManager(ExecutionEngine *engine)
     , aggressiveGC(!qEnvironmentVariableIsEmpty("QV4_MM_AGGRESSIVE_GC"))
     , gcStats(lcGcStats().isDebugEnabled())
     , gcCollectorStats(lcGcAllocatorStats().isDebugEnabled())
+    , incrementalSweep(!qEnvironmentVariableIsEmpty("QV4_MM_INCREMENTAL_SWEEP"))
+    , concurrentSweep(!qEnvironmentVariableIsEmpty("QV4_MM_CONCURRENT_SWEEP"))
 {
 #ifdef V4_USE_VALGRIND
     VALGRIND_CREATE_MEMPOOL(this, 0, true);
 #endif
+    bool ok = false;
+    const int envSweepTimeLimit = qEnvironmentVariableIntValue("QV4_MM_SWEEP_TIME_LIMIT", &ok);
+    if (ok && envSweepTimeLimit >= 0)
+        sweepTimeLimit = envSweepTimeLimit;
+    if (concurrentSweep)
+        incrementalSweep = true;
+
     memset(statistics.allocations, 0, sizeof(statistics.allocations));
     if (gcStats)
         blockAllocator.allocationStats = statistics.allocations;
@@ -991,12 +1270,47 @@ void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPt
 
     if (!lastSweep) {
         engine->identifierTable->sweep();
-        blockAllocator.sweep(/*classCountPtr*/);
-        hugeItemAllocator.sweep(classCountPtr);
-        icAllocator.sweep(/*classCountPtr*/);
+        if (incrementalSweep && !aggressiveGC && !classCountPtr) {
+            // The destroy() methods of the objects left in the block allocator still need their
+            // internal classes. Keep the unmarked ones around until all other chunks have been
+            // swept, but make sure they can't be found through a transition anymore.
+            blockAllocator.startIncrementalSweep();
+            hugeItemAllocator.sweep(classCountPtr);
+            icAllocator.startIncrementalSweep();
+            for (Chunk *c : icAllocator.chunksToSweep)
+                c->detachUnmarkedInternalClasses();
+            if (concurrentSweep && !engine->profiler())
+                blockAllocator.startBackgroundSweep();
+        } else {
+            blockAllocator.sweep(/*classCountPtr*/);
+            hugeItemAllocator.sweep(classCountPtr);
+            icAllocator.sweep(/*classCountPtr*/);
+        }
+    }
+}
+
+void MemoryManager::sweepPendingChunks(QDeadlineTimer deadline)
+{
+    while (blockAllocator.sweepNextChunk()) {
+        if (deadline.hasExpired())
+            return;
+    }
+
+    if (icAllocator.hasPendingSweep()) {
+        icAllocator.sweepPendingChunks();
+        usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
     }
 }
 
+void MemoryManager::sweepIncrementally()
+{
+    if (gcBlocked || !hasPendingSweep())
+        return;
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    sweepPendingChunks(QDeadlineTimer(sweepTimeLimit));
+}
+
 bool MemoryManager::shouldRunGC() const
 {
     size_t total = blockAllocator.totalSlots() + icAllocator.totalSlots();
@@ -1034,6 +1348,39 @@ static size_t dumpBins(BlockAllocator *b, const char *title)
     return totalSlotMem*Chunk::SlotSize;
 }
 
+static void dumpInternalClassStats(ExecutionEngine *engine, size_t usedMem)
+{
+    const QLoggingCategory &stats = lcGcAllocatorStats();
+    size_t classes = 0;
+    size_t transitions = 0;
+    size_t deadTransitions = 0;
+    size_t transitionMem = 0;
+    uint maxMembers = 0;
+
+    // All internal classes are created by transitions from the empty class
+    std::vector<Heap::InternalClass *> todo;
+    todo.push_back(engine->internalClasses(EngineBase::Class_Empty));
+    while (!todo.empty()) {
+        Heap::InternalClass *ic = todo.back();
+        todo.pop_back();
+        ++classes;
+        maxMembers = qMax(maxMembers, ic->size);
+        transitions += ic->transitions.size();
+        transitionMem += ic->transitions.capacity() * sizeof(InternalClassTransition);
+        for (const InternalClassTransition &t : ic->transitions) {
+            if (t.lookup)
+                todo.push_back(t.lookup);
+            else
+                ++deadTransitions;
+        }
+    }
+
+    qDebug(stats) << "Internal classes:" << classes << "using" << usedMem << "bytes";
+    qDebug(stats) << "    transitions" << transitions << "of which" << deadTransitions << "lead to freed classes";
+    qDebug(stats) << "    memory in transition tables" << transitionMem;
+    qDebug(stats) << "    largest number of members" << maxMembers;
+}
+
 void MemoryManager::runGC()
 {
     if (gcBlocked) {
@@ -1044,6 +1391,10 @@ void MemoryManager::runGC()
     QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
 //    qDebug() << "runGC";
 
+    // the previous run has to be completed before its mark bits can be reused
+    if (hasPendingSweep())
+        sweepPendingChunks(QDeadlineTimer(QDeadlineTimer::Forever));
+
     if (gcStats) {
         statistics.maxReservedMem = qMax(statistics.maxReservedMem, getAllocatedMem());
         statistics.maxAllocatedMem = qMax(statistics.maxAllocatedMem, getUsedMem() + getLargeItemsMem());
@@ -1126,6 +1477,8 @@ void MemoryManager::runGC()
             qDebug(stats).noquote() << QString::fromLatin1("Freed JS type: %1 (%2 instances)").arg(QString::fromLatin1(it->first), QString::number(it->second));
         }
 
+        dumpInternalClassStats(engine, icAllocator.usedMem());
+
         qDebug(stats) << "======== End GC ========";
     }
 
@@ -1140,9 +1493,10 @@ void MemoryManager::runGC()
                  == icAllocator.usedMem() + dumpBins(&icAllocator, nullptr));
     }
 
-    usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
+    if (!hasPendingSweep())
+        usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
 
-    // reset all black bits
+    // reset all black bits, chunks that still need to be swept keep theirs until then
     blockAllocator.resetBlackBits();
     hugeItemAllocator.resetBlackBits();
     icAllocator.resetBlackBits();
@@ -1177,6 +1531,11 @@ void MemoryManager::registerWeakSet(Heap::SetObject *set)
 
 MemoryManager::~MemoryManager()
 {
+    if (hasPendingSweep()) {
+        QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+        sweepPendingChunks(QDeadlineTimer(QDeadlineTimer::Forever));
+    }
+
     delete m_persistentValues;
 
     dumpStats();
@@ -57,6 +57,7 @@
 #include <private/qv4object_p.h>
 #include <private/qv4mmdefs_p.h>
 #include <QVector>
+#include <QDeadlineTimer>
 
 #define QV4_MM_MAXBLOCK_SHIFT "QV4_MM_MAXBLOCK_SHIFT"
 #define QV4_MM_MAX_CHUNK_SIZE "QV4_MM_MAX_CHUNK_SIZE"
@@ -70,6 +71,7 @@ namespace QV4 {
 
 struct ChunkAllocator;
 struct MemorySegment;
+struct BackgroundSweeper;
 
 struct BlockAllocator {
     BlockAllocator(ChunkAllocator *chunkAllocator, ExecutionEngine *engine)
@@ -77,9 +79,20 @@ struct BlockAllocator {
     {
         memset(freeBins, 0, sizeof(freeBins));
     }
+    ~BlockAllocator();
 
     enum { NumBins = 8 };
 
+    struct SweepJob {
+        Chunk *chunk;
+        size_t usedSlotsBefore;
+        size_t usedSlotsAfter;
+        bool swept; // by the background thread
+        bool hasUsedSlots;
+        HeapItem *bins[NumBins];
+        HeapItem *lastInBins[NumBins];
+    };
+
     static inline size_t binForSlots(size_t nSlots) {
         return nSlots >= NumBins ? NumBins - 1 : nSlots;
     }
@@ -87,20 +100,29 @@ struct BlockAllocator {
     HeapItem *allocate(size_t size, bool forceAllocation = false);
 
     size_t totalSlots() const {
-        return Chunk::AvailableSlots*chunks.size();
+        return Chunk::AvailableSlots*(chunks.size() + chunksToSweep.size() + chunksInBackgroundSweep);
     }
 
     size_t allocatedMem() const {
-        return chunks.size()*Chunk::DataSize;
+        return (chunks.size() + chunksToSweep.size() + chunksInBackgroundSweep + emptyChunks.size())
+                * Chunk::DataSize;
     }
     size_t usedMem() const {
         uint used = 0;
         for (auto c : chunks)
             used += c->nUsedSlots()*Chunk::SlotSize;
-        return used;
+        for (auto c : chunksToSweep)
+            used += c->nUsedSlots()*Chunk::SlotSize;
+        return used + slotsInBackgroundSweep*Chunk::SlotSize;
     }
 
     void sweep();
+    void startIncrementalSweep();
+    void startBackgroundSweep();
+    void takeChunkFromBackgroundSweep();
+    bool sweepNextChunk();
+    void sweepPendingChunks();
+    bool hasPendingSweep() const { return !chunksToSweep.empty() || chunksInBackgroundSweep; }
     void freeAll();
     void resetBlackBits();
     void collectGrayItems(MarkStack *markStack);
@@ -113,6 +135,16 @@ struct BlockAllocator {
     ChunkAllocator *chunkAllocator;
     ExecutionEngine *engine;
     std::vector<Chunk *> chunks;
+    // chunks still holding the mark bits of the last GC run, and chunks found to be empty while
+    // sweeping those incrementally. The latter are only released once all chunks have been swept.
+    std::vector<Chunk *> chunksToSweep;
+    std::vector<Chunk *> emptyChunks;
+    // chunks handed over to the background sweeper and not taken back yet, together with the
+    // number of slots they used before being swept
+    BackgroundSweeper *backgroundSweeper = nullptr;
+    size_t chunksInBackgroundSweep = 0;
+    size_t slotsInBackgroundSweep = 0;
+    size_t chunksSweptInBackground = 0;
     uint *allocationStats = nullptr;
 };
 
@@ -257,6 +289,10 @@ public:
 
     void runGC();
 
+    bool hasPendingSweep() const
+    { return blockAllocator.hasPendingSweep() || icAllocator.hasPendingSweep(); }
+    void sweepIncrementally();
+
     void dumpStats() const;
 
     size_t getUsedMem() const;
@@ -285,12 +321,14 @@ protected:
 
 private:
     enum {
-        MinUnmanagedHeapSizeGCLimit = 128 * 1024
+        MinUnmanagedHeapSizeGCLimit = 128 * 1024,
+        DefaultSweepTimeLimit = 2 // ms
     };
 
     void collectFromJSStack(MarkStack *markStack) const;
     void mark();
     void sweep(bool lastSweep = false, ClassDestroyStatsCallback classCountPtr = nullptr);
+    void sweepPendingChunks(QDeadlineTimer deadline);
     bool shouldRunGC() const;
     void collectRoots(MarkStack *markStack);
 
@@ -324,6 +362,12 @@ private:
         if (HeapItem *m = allocator->allocate(size))
             return m;
 
+        if (hasPendingSweep()) {
+            sweepIncrementally();
+            if (HeapItem *m = allocator->allocate(size))
+                return m;
+        }
+
         if (!didGCRun && shouldRunGC())
             runGC();
 
@@ -351,6 +395,15 @@ public:
     bool gcStats = false;
     bool gcCollectorStats = false;
 
+    // When set, the heap is only swept right away for huge items and strings in the identifier
+    // table. The remaining chunks are swept lazily from the allocation path, spending at most
+    // sweepTimeLimit milliseconds per slice.
+    bool incrementalSweep = false;
+    // When also set, unmarked items are destroyed right away, and the chunks of the block
+    // allocator are then swept on a thread from the global thread pool.
+    bool concurrentSweep = false;
+    int sweepTimeLimit = DefaultSweepTimeLimit;
+
     int allocationCount = 0;
     size_t lastAllocRequestedSlots = 0;
 
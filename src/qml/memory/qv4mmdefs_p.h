@@ -190,8 +190,10 @@ struct Chunk {
     bool sweep(ClassDestroyStatsCallback classCountPtr);
     void resetBlackBits();
     void collectGrayItems(QV4::MarkStack *markStack);
-    bool sweep(ExecutionEngine *engine);
+    bool sweep(ExecutionEngine *engine, bool destroyItems = true);
     void freeAll(ExecutionEngine *engine);
+    void detachUnmarkedInternalClasses();
+    void destroyUnmarkedItems();
 
     void sortIntoBins(HeapItem **bins, uint nBins);
 };
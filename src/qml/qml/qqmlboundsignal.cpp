@@ -173,6 +173,39 @@ QString QQmlBoundSignalExpression::expression() const
     return QString();
 }
 
+bool QQmlBoundSignalExpression::resolveArguments()
+{
+    QQmlEnginePrivate *ep = QQmlEnginePrivate::get(engine());
+
+    QQmlMetaObject::ArgTypeStorage storage;
+    //TODO: lookup via signal index rather than method index as an optimization
+    int methodIndex = QMetaObjectPrivate::signal(m_target->metaObject(), m_index).methodIndex();
+    int *argsTypes = QQmlMetaObject(m_target).methodParameterTypes(methodIndex, &storage, nullptr);
+    if (!argsTypes)
+        return false;
+
+    const int argCount = *argsTypes;
+    m_arguments.resize(argCount);
+    for (int ii = 0; ii < argCount; ++ii) {
+        SignalArgument &argument = m_arguments[ii];
+        argument.type = argsTypes[ii + 1];
+        //### ideally we would use metaTypeToJS, however it currently gives different results
+        //    for several cases (such as QVariant type and QObject-derived types)
+        if (argument.type == qMetaTypeId<QJSValue>())
+            argument.conversion = JSValueArgument;
+        else if (argument.type == QMetaType::QVariant)
+            argument.conversion = VariantArgument;
+        else if (argument.type == QMetaType::Int)
+            argument.conversion = IntArgument;
+        else if (ep->isQObject(argument.type))
+            argument.conversion = QObjectArgument;
+        else
+            argument.conversion = GenericArgument;
+    }
+    m_argumentsResolved = true;
+    return true;
+}
+
 // Parts of this function mirror code in QQmlExpressionPrivate::value() and v8value().
 // Changes made here may need to be made there and vice versa.
 void QQmlBoundSignalExpression::evaluate(void **a)
@@ -189,35 +222,38 @@ void QQmlBoundSignalExpression::evaluate(void **a)
 
     ep->referenceScarceResources(); // "hold" scarce resources in memory during evaluation.
 
-    QQmlMetaObject::ArgTypeStorage storage;
-    //TODO: lookup via signal index rather than method index as an optimization
-    int methodIndex = QMetaObjectPrivate::signal(m_target->metaObject(), m_index).methodIndex();
-    int *argsTypes = QQmlMetaObject(m_target).methodParameterTypes(methodIndex, &storage, nullptr);
-    int argCount = argsTypes ? *argsTypes : 0;
+    // Handlers that read neither their parameters nor the arguments object get called
+    // without any, which saves converting them on every emission.
+    int argCount = 0;
+    if (!function()->ignoresArguments() && (m_argumentsResolved || resolveArguments()))
+        argCount = m_arguments.count();
 
     QV4::JSCallData jsCall(scope, argCount);
     for (int ii = 0; ii < argCount; ++ii) {
-        int type = argsTypes[ii + 1];
-        //### ideally we would use metaTypeToJS, however it currently gives different results
-        //    for several cases (such as QVariant type and QObject-derived types)
-        //args[ii] = engine->metaTypeToJS(type, a[ii + 1]);
-        if (type == qMetaTypeId<QJSValue>()) {
+        const SignalArgument &argument = m_arguments.at(ii);
+        switch (argument.conversion) {
+        case JSValueArgument:
             if (QV4::Value *v4Value = QJSValuePrivate::valueForData(reinterpret_cast<QJSValue *>(a[ii + 1]), &jsCall->args[ii]))
                 jsCall->args[ii] = *v4Value;
             else
                 jsCall->args[ii] = QV4::Encode::undefined();
-        } else if (type == QMetaType::QVariant) {
+            break;
+        case VariantArgument:
             jsCall->args[ii] = scope.engine->fromVariant(*((QVariant *)a[ii + 1]));
-        } else if (type == QMetaType::Int) {
+            break;
+        case IntArgument:
             //### optimization. Can go away if we switch to metaTypeToJS, or be expanded otherwise
             jsCall->args[ii] = QV4::Value::fromInt32(*reinterpret_cast<const int*>(a[ii + 1]));
-        } else if (ep->isQObject(type)) {
+            break;
+        case QObjectArgument:
             if (!*reinterpret_cast<void* const *>(a[ii + 1]))
                 jsCall->args[ii] = QV4::Value::nullValue();
             else
                 jsCall->args[ii] = QV4::QObjectWrapper::wrap(v4, *reinterpret_cast<QObject* const *>(a[ii + 1]));
-        } else {
-            jsCall->args[ii] = scope.engine->fromVariant(QVariant(type, a[ii + 1]));
+            break;
+        case GenericArgument:
+            jsCall->args[ii] = scope.engine->fromVariant(QVariant(argument.type, a[ii + 1]));
+            break;
         }
     }
 
@@ -239,8 +275,9 @@ void QQmlBoundSignalExpression::evaluate(const QList<QVariant> &args)
 
     ep->referenceScarceResources(); // "hold" scarce resources in memory during evaluation.
 
-    QV4::JSCallData jsCall(scope, args.count());
-    for (int ii = 0; ii < args.count(); ++ii) {
+    const int argCount = function()->ignoresArguments() ? 0 : args.count();
+    QV4::JSCallData jsCall(scope, argCount);
+    for (int ii = 0; ii < argCount; ++ii) {
         jsCall->args[ii] = scope.engine->fromVariant(args[ii]);
     }
 
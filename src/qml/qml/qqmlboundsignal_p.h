@@ -52,6 +52,7 @@
 //
 
 #include <QtCore/qmetaobject.h>
+#include <QtCore/qvector.h>
 
 #include <private/qqmljavascriptexpression_p.h>
 #include <private/qqmlboundsignalexpressionpointer_p.h>
@@ -96,8 +97,26 @@ private:
 
     bool expressionFunctionValid() const { return function() != nullptr; }
 
+    // How a signal argument is turned into a JS value, resolved once per expression
+    enum ArgumentConversion : quint8 {
+        JSValueArgument,
+        VariantArgument,
+        IntArgument,
+        QObjectArgument,
+        GenericArgument
+    };
+
+    struct SignalArgument {
+        int type;
+        ArgumentConversion conversion;
+    };
+
+    bool resolveArguments();
+
     int m_index;
+    bool m_argumentsResolved = false;
     QObject *m_target;
+    QVector<SignalArgument> m_arguments;
 };
 
 class Q_QML_PRIVATE_EXPORT QQmlBoundSignal : public QQmlNotifierEndpoint
@@ -166,7 +166,9 @@ QV4::ReturnedValue QQmlDelayedCallQueue::addUniquelyAndExecuteLater(const QV4::F
             dfc.m_guarded = true;
         }
     }
-    storeAnyArguments(dfc, argv, argc, 1, m_engine);
+    // Don't keep arguments alive for a callback that never looks at them
+    const QV4::Function *function = func->function();
+    storeAnyArguments(dfc, argv, function && function->ignoresArguments() ? 1 : argc, 1, m_engine);
 
     if (!m_callbackOutstanding) {
         m_tickedMethod.invoke(this, Qt::QueuedConnection);
@@ -47,6 +47,9 @@
 #include <QtCore/qpluginloader.h>
 #include <QtCore/qlibraryinfo.h>
 #include <QtCore/qreadwritelock.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qsavefile.h>
 #include <QtQml/qqmlextensioninterface.h>
 #include <QtQml/qqmlextensionplugin.h>
 #include <private/qqmlextensionplugin_p.h>
@@ -1387,6 +1390,19 @@ QQmlImports::LocalQmldirResult QQmlImportsPrivate::locateLocalQmldir(
 
     // Interceptor might redirect remote files to local ones.
     QQmlAbstractUrlInterceptor *interceptor = typeLoader.engine()->urlInterceptor();
+
+    // Results of earlier runs, only meaningful if nothing is redirected
+    QQmlImportDatabase::LookupSnapshot *snapshot = interceptor ? nullptr : database->lookupSnapshot();
+    if (snapshot && snapshot->findQmldir(uri, vmaj, vmin, outQmldirFilePath, outQmldirPathUrl)) {
+        QQmlImportDatabase::QmldirCache *cache = new QQmlImportDatabase::QmldirCache;
+        cache->versionMajor = vmaj;
+        cache->versionMinor = vmin;
+        cache->qmldirFilePath = *outQmldirFilePath;
+        cache->qmldirPathUrl = *outQmldirPathUrl;
+        cache->next = cacheHead;
+        database->qmldirCache.insert(uri, cache);
+        return QQmlImports::QmldirFound;
+    }
     QStringList localImportPaths = database->importPathList(
                 interceptor ? QQmlImportDatabase::LocalOrRemote : QQmlImportDatabase::Local);
 
@@ -1421,6 +1437,9 @@ QQmlImports::LocalQmldirResult QQmlImportsPrivate::locateLocalQmldir(
             cache->next = cacheHead;
             database->qmldirCache.insert(uri, cache);
 
+            if (snapshot)
+                snapshot->addQmldir(uri, vmaj, vmin, absoluteFilePath, url);
+
             *outQmldirFilePath = absoluteFilePath;
             *outQmldirPathUrl = url;
 
@@ -1877,6 +1896,208 @@ void QQmlImports::setDesignerSupportRequired(bool b)
 }
 
 
+/*
+Locating a module means probing for qmldir files in all import paths, for several
+version suffixes each, and then for the plugin in all plugin paths with all the
+possible prefixes and suffixes. The results are stored in the file named by
+QML_IMPORT_LOOKUP_CACHE, so that the next process can check a single file
+instead.
+
+A snapshot is only used with the same Qt version, import paths and plugin paths.
+Each entry is checked against the time stamp of the file it points to, so modules
+that are removed or updated are probed for again. Installing a module into an
+import path that takes precedence over the one it was found in is not detected;
+delete the snapshot after doing so.
+*/
+class QQmlImportDatabase::LookupSnapshot
+{
+public:
+    LookupSnapshot(const QString &fileName, const QStringList &importPaths,
+                   const QStringList &pluginPaths);
+    ~LookupSnapshot();
+
+    bool findQmldir(const QString &uri, int vmaj, int vmin, QString *filePath, QString *pathUrl) const;
+    void addQmldir(const QString &uri, int vmaj, int vmin, const QString &filePath, const QString &pathUrl);
+
+    QString findPlugin(const QString &key) const;
+    void addPlugin(const QString &key, const QString &filePath);
+
+private:
+    struct Entry {
+        QString filePath;
+        QString url;
+        qint64 timeStamp = -1;
+    };
+
+    static QString qmldirKey(const QString &uri, int vmaj, int vmin);
+    static qint64 timeStamp(const QString &filePath);
+    const Entry *find(const QString &key) const;
+    void add(const QString &key, const QString &filePath, const QString &url);
+
+    void load();
+    void save() const;
+
+    QString fileName;
+    QStringList importPaths;
+    QStringList pluginPaths;
+    QHash<QString, Entry> entries;
+    bool modified = false;
+};
+
+static const quint32 lookupSnapshotMagic = 0x716d6c69; // "qmli"
+
+QQmlImportDatabase::LookupSnapshot::LookupSnapshot(const QString &fileName,
+                                                   const QStringList &importPaths,
+                                                   const QStringList &pluginPaths)
+    : fileName(fileName), importPaths(importPaths), pluginPaths(pluginPaths)
+{
+    load();
+}
+
+QQmlImportDatabase::LookupSnapshot::~LookupSnapshot()
+{
+    if (modified)
+        save();
+}
+
+QString QQmlImportDatabase::LookupSnapshot::qmldirKey(const QString &uri, int vmaj, int vmin)
+{
+    return uri + QLatin1Char(' ') + QString::number(vmaj) + QLatin1Char('.') + QString::number(vmin);
+}
+
+qint64 QQmlImportDatabase::LookupSnapshot::timeStamp(const QString &filePath)
+{
+    // Resources can't change and are cheap to look up anyway.
+    if (filePath.isEmpty() || filePath.startsWith(Colon))
+        return -1;
+    const QDateTime lastModified = QFileInfo(filePath).lastModified();
+    return lastModified.isValid() ? lastModified.toMSecsSinceEpoch() : -1;
+}
+
+const QQmlImportDatabase::LookupSnapshot::Entry *QQmlImportDatabase::LookupSnapshot::find(
+        const QString &key) const
+{
+    const auto it = entries.constFind(key);
+    if (it == entries.constEnd() || it->timeStamp != timeStamp(it->filePath))
+        return nullptr;
+    return &*it;
+}
+
+void QQmlImportDatabase::LookupSnapshot::add(const QString &key, const QString &filePath,
+                                             const QString &url)
+{
+    const qint64 stamp = timeStamp(filePath);
+    if (stamp == -1)
+        return;
+
+    Entry &entry = entries[key];
+    if (entry.filePath == filePath && entry.url == url && entry.timeStamp == stamp)
+        return;
+    entry.filePath = filePath;
+    entry.url = url;
+    entry.timeStamp = stamp;
+    modified = true;
+}
+
+bool QQmlImportDatabase::LookupSnapshot::findQmldir(const QString &uri, int vmaj, int vmin,
+                                                    QString *filePath, QString *pathUrl) const
+{
+    const Entry *entry = find(qmldirKey(uri, vmaj, vmin));
+    if (!entry)
+        return false;
+    *filePath = entry->filePath;
+    *pathUrl = entry->url;
+    return true;
+}
+
+void QQmlImportDatabase::LookupSnapshot::addQmldir(const QString &uri, int vmaj, int vmin,
+                                                   const QString &filePath, const QString &pathUrl)
+{
+    add(qmldirKey(uri, vmaj, vmin), filePath, pathUrl);
+}
+
+QString QQmlImportDatabase::LookupSnapshot::findPlugin(const QString &key) const
+{
+    const Entry *entry = find(key);
+    return entry ? entry->filePath : QString();
+}
+
+void QQmlImportDatabase::LookupSnapshot::addPlugin(const QString &key, const QString &filePath)
+{
+    add(key, filePath, QString());
+}
+
+void QQmlImportDatabase::LookupSnapshot::load()
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const qint64 size = file.size();
+    const uchar *data = file.map(0, size);
+    const QByteArray contents = data ? QByteArray::fromRawData(reinterpret_cast<const char *>(data), size)
+                                     : file.readAll();
+
+    QDataStream stream(contents);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0;
+    quint32 qtVersion = 0;
+    QStringList snapshotImportPaths;
+    QStringList snapshotPluginPaths;
+    stream >> magic >> qtVersion >> snapshotImportPaths >> snapshotPluginPaths;
+    if (stream.status() != QDataStream::Ok || magic != lookupSnapshotMagic || qtVersion != QT_VERSION
+            || snapshotImportPaths != importPaths || snapshotPluginPaths != pluginPaths) {
+        if (qmlImportTrace())
+            qDebug() << "QQmlImportDatabase: Ignoring outdated import lookup cache" << fileName;
+        modified = true; // Replace it
+        return;
+    }
+
+    quint32 count = 0;
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString key;
+        Entry entry;
+        stream >> key >> entry.filePath >> entry.url >> entry.timeStamp;
+        entries.insert(key, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        entries.clear();
+        modified = true;
+    }
+}
+
+void QQmlImportDatabase::LookupSnapshot::save() const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (qmlImportTrace())
+            qDebug() << "QQmlImportDatabase: Cannot write import lookup cache" << fileName << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << lookupSnapshotMagic << quint32(QT_VERSION) << importPaths << pluginPaths;
+    stream << quint32(entries.count());
+    for (auto it = entries.constBegin(), end = entries.constEnd(); it != end; ++it)
+        stream << it.key() << it->filePath << it->url << it->timeStamp;
+    file.commit();
+}
+
+QQmlImportDatabase::LookupSnapshot *QQmlImportDatabase::lookupSnapshot()
+{
+    if (!loadedLookupSnapshot) {
+        const QString fileName = qEnvironmentVariable("QML_IMPORT_LOOKUP_CACHE");
+        if (fileName.isEmpty())
+            return nullptr;
+        loadedLookupSnapshot.reset(new LookupSnapshot(fileName, fileImportPath, filePluginPath));
+    }
+    return loadedLookupSnapshot.data();
+}
+
 /*!
 \class QQmlImportDatabase
 \brief The QQmlImportDatabase class manages the QML imports for a QQmlEngine.
@@ -1937,6 +2158,16 @@ QString QQmlImportDatabase::resolvePlugin(QQmlTypeLoader *typeLoader,
                                           const QString &baseName, const QStringList &suffixes,
                                           const QString &prefix)
 {
+    LookupSnapshot *snapshot = lookupSnapshot();
+    QString snapshotKey;
+    if (snapshot) {
+        snapshotKey = qmldirPath + QLatin1Char('\n') + qmldirPluginPath + QLatin1Char('\n')
+                + prefix + baseName + QLatin1Char('\n') + suffixes.join(QLatin1Char(' '));
+        const QString snapshotPath = snapshot->findPlugin(snapshotKey);
+        if (!snapshotPath.isEmpty())
+            return snapshotPath;
+    }
+
     QStringList searchPaths = filePluginPath;
     bool qmldirPluginPathIsRelative = QDir::isRelativePath(qmldirPluginPath);
     if (!qmldirPluginPathIsRelative)
@@ -1971,16 +2202,22 @@ QString QQmlImportDatabase::resolvePlugin(QQmlTypeLoader *typeLoader,
             QString bundledPath = resolvedPath + QLatin1String("lib") + pluginName;
             for (const QString &suffix : suffixes) {
                 const QString absolutePath = typeLoader->absoluteFilePath(bundledPath + suffix);
-                if (!absolutePath.isEmpty())
+                if (!absolutePath.isEmpty()) {
+                    if (snapshot)
+                        snapshot->addPlugin(snapshotKey, absolutePath);
                     return absolutePath;
+                }
             }
         }
 #endif
         resolvedPath += prefix + baseName;
         for (const QString &suffix : suffixes) {
             const QString absolutePath = typeLoader->absoluteFilePath(resolvedPath + suffix);
-            if (!absolutePath.isEmpty())
+            if (!absolutePath.isEmpty()) {
+                if (snapshot)
+                    snapshot->addPlugin(snapshotKey, absolutePath);
                 return absolutePath;
+            }
         }
     }
 
@@ -2346,6 +2583,10 @@ void QQmlImportDatabase::clearDirCache()
         ++itr;
     }
     qmldirCache.clear();
+
+    // Saves the lookups made so far. The next lookup starts a new snapshot for the
+    // current import paths.
+    loadedLookupSnapshot.reset();
 }
 
 void QQmlImportDatabase::finalizePlugin(QObject *instance, const QString &path, const QString &uri)
@@ -42,6 +42,7 @@
 
 #include <QtCore/qurl.h>
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qscopedpointer.h>
 #include <QtCore/qset.h>
 #include <QtCore/qstringlist.h>
 #include <QtQml/qqmlerror.h>
@@ -254,6 +255,12 @@ private:
     void clearDirCache();
     void finalizePlugin(QObject *instance, const QString &path, const QString &uri);
 
+    // Results of locating qmldir files and plugins, kept across runs
+    // if QML_IMPORT_LOOKUP_CACHE is set.
+    class LookupSnapshot;
+    LookupSnapshot *lookupSnapshot();
+    QScopedPointer<LookupSnapshot> loadedLookupSnapshot;
+
     struct QmldirCache {
         int versionMajor;
         int versionMinor;
@@ -900,7 +900,7 @@ bool QQmlObjectCreator::setPropertyBinding(const QQmlPropertyData *bindingProper
 
     if (binding->type == QV4::CompiledData::Binding::Type_Script || binding->isTranslationBinding()) {
         if (binding->flags & QV4::CompiledData::Binding::IsSignalHandlerExpression) {
-            QV4::Function *runtimeFunction = compilationUnit->runtimeFunctions[binding->value.compiledScriptIndex];
+            QV4::Function *runtimeFunction = compilationUnit->runtimeFunctionAt(binding->value.compiledScriptIndex);
             int signalIndex = _propertyCache->methodIndexToSignalIndex(bindingProperty->coreIndex());
             QQmlBoundSignal *bs = new QQmlBoundSignal(_bindingTarget, signalIndex, _scopeObject, engine);
             QQmlBoundSignalExpression *expr = new QQmlBoundSignalExpression(_bindingTarget, signalIndex,
@@ -923,7 +923,7 @@ bool QQmlObjectCreator::setPropertyBinding(const QQmlPropertyData *bindingProper
             if (binding->isTranslationBinding()) {
                 qmlBinding = QQmlBinding::createTranslationBinding(compilationUnit, binding, _scopeObject, context);
             } else {
-                QV4::Function *runtimeFunction = compilationUnit->runtimeFunctions[binding->value.compiledScriptIndex];
+                QV4::Function *runtimeFunction = compilationUnit->runtimeFunctionAt(binding->value.compiledScriptIndex);
                 qmlBinding = QQmlBinding::create(targetProperty, runtimeFunction, _scopeObject, context, currentQmlContext());
             }
 
@@ -1117,7 +1117,7 @@ void QQmlObjectCreator::setupFunctions()
 
     const quint32_le *functionIdx = _compiledObject->functionOffsetTable();
     for (quint32 i = 0; i < _compiledObject->nFunctions; ++i, ++functionIdx) {
-        QV4::Function *runtimeFunction = compilationUnit->runtimeFunctions[*functionIdx];
+        QV4::Function *runtimeFunction = compilationUnit->runtimeFunctionAt(*functionIdx);
         const QString name = runtimeFunction->name()->toQString();
 
         QQmlPropertyData *property = _propertyCache->property(name, _qobject, context);
@@ -1132,6 +1132,57 @@ void QQmlObjectCreator::setupFunctions()
     }
 }
 
+const QV4::ObjectRequiredProperties &QQmlObjectCreator::requiredPropertiesForObject()
+{
+    QVector<QV4::ObjectRequiredProperties> &perObject = compilationUnit->requiredPropertiesPerObject;
+    if (perObject.isEmpty())
+        perObject.resize(compilationUnit->objectCount());
+    QV4::ObjectRequiredProperties &required = perObject[_compiledObjectIndex];
+    if (required.collected)
+        return required;
+
+    // Walking the inherited properties is expensive, and the result only depends on the
+    // compiled object and its property cache, so do it once for all instances.
+    QSet<QString> postHocRequired;
+    for (auto it = _compiledObject->requiredPropertyExtraDataBegin(); it != _compiledObject->requiredPropertyExtraDataEnd(); ++it)
+        postHocRequired.insert(stringAt(it->nameIndex));
+    bool hadInheritedRequiredProperties = !postHocRequired.empty();
+
+    for (int propertyIndex = 0; propertyIndex != _compiledObject->propertyCount(); ++propertyIndex) {
+        const QV4::CompiledData::Property* property = _compiledObject->propertiesBegin() + propertyIndex;
+        QQmlPropertyData *propertyData = _propertyCache->property(_propertyCache->propertyOffset() + propertyIndex);
+        // only compute stringAt if there's a chance for the lookup to succeed
+        auto postHocIt = postHocRequired.isEmpty() ? postHocRequired.end() : postHocRequired.find(stringAt(property->nameIndex));
+        if (!property->isRequired && postHocRequired.end() == postHocIt)
+            continue;
+        if (postHocIt != postHocRequired.end())
+            postHocRequired.erase(postHocIt);
+        required.properties.append({propertyData, stringAt(property->nameIndex), property->location});
+    }
+
+    for (int i = 0; i <= _propertyCache->propertyOffset(); ++i) {
+        QQmlPropertyData *propertyData = _propertyCache->maybeUnresolvedProperty(i);
+        if (!propertyData)
+            continue;
+        if (!propertyData->isRequired() && postHocRequired.isEmpty())
+            continue;
+        QString name = propertyData->name(_qobject);
+        auto postHocIt = postHocRequired.find(name);
+        if (!propertyData->isRequired() && postHocRequired.end() == postHocIt )
+            continue;
+
+        if (postHocIt != postHocRequired.end())
+            postHocRequired.erase(postHocIt);
+
+        required.properties.append({propertyData, name, _compiledObject->location});
+    }
+    if (!postHocRequired.isEmpty() && hadInheritedRequiredProperties)
+        required.missingPropertyName = *postHocRequired.begin();
+
+    required.collected = true;
+    return required;
+}
+
 void QQmlObjectCreator::recordError(const QV4::CompiledData::Location &location, const QString &description)
 {
     QQmlError error;
@@ -1510,45 +1561,14 @@ bool QQmlObjectCreator::populateInstance(int index, QObject *instance, QObject *
     if (_compiledObject->flags & QV4::CompiledData::Object::HasDeferredBindings)
         _ddata->deferData(_compiledObjectIndex, compilationUnit, context);
 
-    QSet<QString> postHocRequired;
-    for (auto it = _compiledObject->requiredPropertyExtraDataBegin(); it != _compiledObject->requiredPropertyExtraDataEnd(); ++it)
-        postHocRequired.insert(stringAt(it->nameIndex));
-    bool hadInheritedRequiredProperties = !postHocRequired.empty();
-
-    for (int propertyIndex = 0; propertyIndex != _compiledObject->propertyCount(); ++propertyIndex) {
-        const QV4::CompiledData::Property* property = _compiledObject->propertiesBegin() + propertyIndex;
-        QQmlPropertyData *propertyData = _propertyCache->property(_propertyCache->propertyOffset() + propertyIndex);
-        // only compute stringAt if there's a chance for the lookup to succeed
-        auto postHocIt = postHocRequired.isEmpty() ? postHocRequired.end() : postHocRequired.find(stringAt(property->nameIndex));
-        if (!property->isRequired && postHocRequired.end() == postHocIt)
-            continue;
-        if (postHocIt != postHocRequired.end())
-            postHocRequired.erase(postHocIt);
-        sharedState->hadRequiredProperties = true;
-        sharedState->requiredProperties.insert(propertyData,
-                                               RequiredPropertyInfo {compilationUnit->stringAt(property->nameIndex), compilationUnit->finalUrl(), property->location, {}});
-
-    }
-
-    for (int i = 0; i <= _propertyCache->propertyOffset(); ++i) {
-        QQmlPropertyData *propertyData = _propertyCache->maybeUnresolvedProperty(i);
-        if (!propertyData)
-            continue;
-        if (!propertyData->isRequired() && postHocRequired.isEmpty())
-            continue;
-        QString name = propertyData->name(_qobject);
-        auto postHocIt = postHocRequired.find(name);
-        if (!propertyData->isRequired() && postHocRequired.end() == postHocIt )
-            continue;
-
-        if (postHocIt != postHocRequired.end())
-            postHocRequired.erase(postHocIt);
-
+    const QV4::ObjectRequiredProperties &required = requiredPropertiesForObject();
+    for (const QV4::RequiredPropertyData &data : required.properties) {
         sharedState->hadRequiredProperties = true;
-        sharedState->requiredProperties.insert(propertyData, RequiredPropertyInfo {name,  compilationUnit->finalUrl(), _compiledObject->location, {}});
+        sharedState->requiredProperties.insert(data.property,
+                                               RequiredPropertyInfo {data.name, compilationUnit->finalUrl(), data.location, {}});
     }
-    if (!postHocRequired.isEmpty() && hadInheritedRequiredProperties)
-        recordError({}, QLatin1String("Property %1 was marked as required but does not exist").arg(*postHocRequired.begin()));
+    if (!required.missingPropertyName.isEmpty())
+        recordError({}, QLatin1String("Property %1 was marked as required but does not exist").arg(required.missingPropertyName));
 
     if (_compiledObject->nFunctions > 0)
         setupFunctions();
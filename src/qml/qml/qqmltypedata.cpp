@@ -315,8 +315,11 @@ void QQmlTypeData::done()
     auto cleanup = qScopeGuard([this]{
         m_document.reset();
         m_typeReferences.clear();
-        if (isError())
+        if (isError()) {
             m_compiledData = nullptr;
+            // The document parsed ahead for us is left over if we failed before getting our data
+            typeLoader()->dropParsedSource(url());
+        }
     });
 
     if (isError())
@@ -575,10 +578,16 @@ bool QQmlTypeData::loadImplicitImport()
 
 void QQmlTypeData::dataReceived(const SourceCodeData &data)
 {
+    // Take it in any case, so that it is dropped if the disk cache is used after all
+    const QSharedPointer<QQmlTypeLoader::ParsedSource> parsedSource = typeLoader()->takeParsedSource(url());
+
     m_backupSourceCode = data;
 
-    if (tryLoadFromDiskCache())
+    if (tryLoadFromDiskCache()) {
+        if (parsedSource)
+            parsedSource->cancel();
         return;
+    }
 
     if (isError())
         return;
@@ -593,7 +602,7 @@ void QQmlTypeData::dataReceived(const SourceCodeData &data)
         return;
     }
 
-    if (!loadFromSource())
+    if (!loadFromSource(parsedSource.data()))
         return;
 
     continueLoadFromIR();
@@ -610,24 +619,35 @@ void QQmlTypeData::initializeFromCachedUnit(const QV4::CompiledData::Unit *unit)
     continueLoadFromIR();
 }
 
-bool QQmlTypeData::loadFromSource()
+bool QQmlTypeData::loadFromSource(QQmlTypeLoader::ParsedSource *parsedSource)
 {
-    m_document.reset(new QmlIR::Document(isDebugging()));
-    m_document->jsModule.sourceTimeStamp = m_backupSourceCode.sourceTimeStamp();
-    QQmlEngine *qmlEngine = typeLoader()->engine();
-    QmlIR::IRBuilder compiler(qmlEngine->handle()->illegalNames());
-
     QString sourceError;
-    const QString source = m_backupSourceCode.readAll(&sourceError);
+    QList<QQmlJS::DiagnosticMessage> parseErrors;
+    bool parsed = false;
+
+    if (parsedSource && parsedSource->waitForResult()
+            && parsedSource->document->jsModule.sourceTimeStamp == m_backupSourceCode.sourceTimeStamp()) {
+        m_document.swap(parsedSource->document);
+        sourceError = parsedSource->sourceError;
+        parseErrors = parsedSource->errors;
+        parsed = sourceError.isEmpty() && parseErrors.isEmpty();
+    } else {
+        m_document.reset(new QmlIR::Document(isDebugging()));
+        QQmlEngine *qmlEngine = typeLoader()->engine();
+        parsed = QQmlTypeLoader::ParsedSource::parse(m_backupSourceCode, finalUrlString(),
+                                                     qmlEngine->handle()->illegalNames(),
+                                                     m_document.data(), &sourceError, &parseErrors);
+    }
+
     if (!sourceError.isEmpty()) {
         setError(sourceError);
         return false;
     }
 
-    if (!compiler.generateFromQml(source, finalUrlString(), m_document.data())) {
+    if (!parsed) {
         QList<QQmlError> errors;
-        errors.reserve(compiler.errors.count());
-        for (const QQmlJS::DiagnosticMessage &msg : qAsConst(compiler.errors)) {
+        errors.reserve(parseErrors.count());
+        for (const QQmlJS::DiagnosticMessage &msg : qAsConst(parseErrors)) {
             QQmlError e;
             e.setUrl(url());
             e.setLine(qmlConvertSourceCoordinate<quint32, int>(msg.loc.startLine));
@@ -850,6 +870,14 @@ void QQmlTypeData::resolveTypes()
         }
     }
 
+    // Resolve all names first and only then load the composite types. This way the
+    // documents of all of them can be parsed ahead in parallel while the first one is
+    // being loaded.
+    const bool parseAhead = m_document && !m_document->javaScriptCompilationUnit.unitData();
+    QVector<QUrl> parsedAhead;
+    QVector<QPair<int, TypeReference>> resolvedTypes;
+    resolvedTypes.reserve(m_typeReferences.count());
+
     for (QV4::CompiledData::TypeReferenceMap::ConstIterator unresolvedRef = m_typeReferences.constBegin(), end = m_typeReferences.constEnd();
          unresolvedRef != end; ++unresolvedRef) {
 
@@ -866,9 +894,30 @@ void QQmlTypeData::resolveTypes()
 
         if (!resolveType(name, majorVersion, minorVersion, ref, unresolvedRef->location.line,
                          unresolvedRef->location.column, reportErrors,
-                         QQmlType::AnyRegistrationType, selfReferenceDetection) && reportErrors)
+                         QQmlType::AnyRegistrationType, selfReferenceDetection) && reportErrors) {
+            // None of the types are going to be loaded
+            for (const QUrl &url : qAsConst(parsedAhead))
+                typeLoader()->dropParsedSource(url);
             return;
+        }
+
+        if (parseAhead && ref.type.isComposite() && !ref.type.isInlineComponentType() && !ref.selfReference
+                && typeLoader()->parseInBackground(ref.type.sourceUrl())) {
+            parsedAhead.append(ref.type.sourceUrl());
+        }
+
+        ref.majorVersion = majorVersion;
+        ref.minorVersion = minorVersion;
+
+        ref.location.line = unresolvedRef->location.line;
+        ref.location.column = unresolvedRef->location.column;
+
+        ref.needsCreation = unresolvedRef->needsCreation;
+        resolvedTypes.append(qMakePair(unresolvedRef.key(), ref));
+    }
 
+    for (QPair<int, TypeReference> &resolvedType : resolvedTypes) {
+        TypeReference &ref = resolvedType.second;
         if (ref.type.isComposite() && !ref.selfReference) {
             ref.typeData = typeLoader()->getType(ref.type.sourceUrl());
             addDependency(ref.typeData.data());
@@ -884,14 +933,7 @@ void QQmlTypeData::resolveTypes()
                 }
             }
         }
-        ref.majorVersion = majorVersion;
-        ref.minorVersion = minorVersion;
-
-        ref.location.line = unresolvedRef->location.line;
-        ref.location.column = unresolvedRef->location.column;
-
-        ref.needsCreation = unresolvedRef->needsCreation;
-        m_resolvedTypes.insert(unresolvedRef.key(), ref);
+        m_resolvedTypes.insert(resolvedType.first, ref);
     }
 
     // ### this allows enums to work without explicit import or instantiation of the type
@@ -121,7 +121,7 @@ protected:
 
 private:
     bool tryLoadFromDiskCache();
-    bool loadFromSource();
+    bool loadFromSource(QQmlTypeLoader::ParsedSource *parsedSource);
     void restoreIR(QV4::CompiledData::CompilationUnit &&unit);
     void continueLoadFromIR();
     void resolveTypes();
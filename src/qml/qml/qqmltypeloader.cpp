@@ -40,12 +40,14 @@
 #include <private/qqmltypeloader_p.h>
 
 #include <private/qqmldirdata_p.h>
+#include <private/qqmlirbuilder_p.h>
 #include <private/qqmlprofiler_p.h>
 #include <private/qqmlscriptblob_p.h>
 #include <private/qqmltypedata_p.h>
 #include <private/qqmltypeloaderqmldircontent_p.h>
 #include <private/qqmltypeloaderthread_p.h>
 #include <private/qqmlsourcecoordinate_p.h>
+#include <private/qv4executablecompilationunit_p.h>
 
 #include <QtQml/qqmlabstracturlinterceptor.h>
 #include <QtQml/qqmlengine.h>
@@ -58,6 +60,7 @@
 #include <QtCore/qdiriterator.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
 
 #include <functional>
 
@@ -776,6 +779,9 @@ QQmlTypeLoader::~QQmlTypeLoader()
     // Stop the loader thread before releasing resources
     shutdownThread();
 
+    // Wait for documents still being parsed ahead
+    m_parserPool.reset();
+
     clearCache();
 
     invalidate();
@@ -1171,9 +1177,199 @@ void QQmlTypeLoader::clearCache()
     m_qmldirCache.clear();
     m_importDirCache.clear();
     m_importQmlDirCache.clear();
+    {
+        LockHolder<QQmlTypeLoader> holder(this);
+        m_parsedSources.clear();
+    }
     QQmlMetaType::freeUnusedTypesAndCaches();
 }
 
+// Returns whether ExecutableCompilationUnit::loadFromDisk() is likely to succeed for url,
+// only looking at the headers of the cache files.
+static bool hasDiskCacheFile(const QUrl &url, const QDateTime &sourceTimeStamp)
+{
+    const QStringList cachePaths = {
+        QQmlFile::urlToLocalFileOrQrc(url) + QLatin1Char('c'),
+        QV4::ExecutableCompilationUnit::localCacheFilePath(url)
+    };
+    for (const QString &cachePath : cachePaths) {
+        QFile cacheFile(cachePath);
+        if (!cacheFile.open(QIODevice::ReadOnly))
+            continue;
+        QV4::CompiledData::Unit header;
+        if (cacheFile.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header))
+            continue;
+        QString error;
+        if (QV4::ExecutableCompilationUnit::verifyHeader(&header, sourceTimeStamp, &error))
+            return true;
+    }
+    return false;
+}
+
+/*!
+\internal
+Starts parsing the QML document at \a unNormalizedUrl on a worker thread, and
+returns whether it did.
+
+Types referenced by a document are otherwise parsed one after the other on the
+loader thread, as each of them is requested with getType(). Parsing only depends
+on the source text, so it can run ahead for all of them at once. The result is
+picked up with takeParsedSource() once the type is loaded; everything else,
+including resolving imports and types, still happens in dependency order on the
+loader thread.
+*/
+bool QQmlTypeLoader::parseInBackground(const QUrl &unNormalizedUrl)
+{
+    ASSERT_LOADTHREAD();
+
+    const int workerCount = QThread::idealThreadCount() - 1;
+    if (workerCount < 1 || m_engine->urlInterceptor())
+        return false;
+
+    const QUrl url = normalize(unNormalizedUrl);
+    if (!QQmlFile::isSynchronous(url))
+        return false;
+
+    {
+        LockHolder<QQmlTypeLoader> holder(this);
+        if (m_typeCache.contains(url) || m_parsedSources.contains(url))
+            return false;
+    }
+
+    // Look at the files without holding the lock, which the GUI thread also takes.
+    QQmlMetaType::CachedUnitLookupError error = QQmlMetaType::CachedUnitLookupError::NoError;
+    if (QQmlMetaType::findCachedCompilationUnit(url, &error))
+        return false;
+
+    QQmlDataBlob::SourceCodeData source;
+    source.fileInfo = QFileInfo(QQmlFile::urlToLocalFileOrQrc(url));
+
+    // Documents that will be loaded from the disk cache are not parsed at all
+    QV4::ExecutionEngine *v4 = m_engine->handle();
+    const bool diskCacheEnabled = (!disableDiskCache() && !v4->debugger()) || forceDiskCache();
+    if (diskCacheEnabled && QQmlFile::isLocalFile(url)
+            && hasDiskCacheFile(url, source.sourceTimeStamp())) {
+        return false;
+    }
+
+    QSharedPointer<ParsedSource> parsed(new ParsedSource(source, url.toString(), v4->illegalNames(),
+                                                         v4->debugger() != nullptr));
+    {
+        LockHolder<QQmlTypeLoader> holder(this);
+        if (m_typeCache.contains(url) || m_parsedSources.contains(url))
+            return false;
+        m_parsedSources.insert(url, parsed);
+        ++m_parseAheadCount;
+    }
+
+    if (!m_parserPool) {
+        m_parserPool.reset(new QThreadPool);
+        m_parserPool->setMaxThreadCount(workerCount);
+    }
+    m_parserPool->start(QRunnable::create([parsed]() { parsed->run(); }));
+    return true;
+}
+
+/*!
+\internal
+Returns the document started with parseInBackground() for \a url, if any, and
+forgets about it.
+*/
+QSharedPointer<QQmlTypeLoader::ParsedSource> QQmlTypeLoader::takeParsedSource(const QUrl &url)
+{
+    LockHolder<QQmlTypeLoader> holder(this);
+    return m_parsedSources.take(url);
+}
+
+/*!
+\internal
+Returns how many documents parseInBackground() has started parsing.
+*/
+int QQmlTypeLoader::parseAheadCount()
+{
+    LockHolder<QQmlTypeLoader> holder(this);
+    return m_parseAheadCount;
+}
+
+/*!
+\internal
+Forgets the document started with parseInBackground() for \a unNormalizedUrl, if
+any, when its type is not going to be loaded after all.
+*/
+void QQmlTypeLoader::dropParsedSource(const QUrl &unNormalizedUrl)
+{
+    const QUrl url = normalize(unNormalizedUrl);
+    QSharedPointer<ParsedSource> parsed;
+    {
+        LockHolder<QQmlTypeLoader> holder(this);
+        parsed = m_parsedSources.take(url);
+    }
+    if (parsed)
+        parsed->cancel();
+}
+
+QQmlTypeLoader::ParsedSource::ParsedSource(const QQmlDataBlob::SourceCodeData &source,
+                                           const QString &url, const QSet<QString> &illegalNames,
+                                           bool debugMode)
+    : document(new QmlIR::Document(debugMode)), source(source), url(url),
+      illegalNames(illegalNames), state(Queued)
+{
+}
+
+QQmlTypeLoader::ParsedSource::~ParsedSource()
+{
+}
+
+void QQmlTypeLoader::ParsedSource::run()
+{
+    if (!state.testAndSetOrdered(Queued, Running))
+        return;
+    parse(source, url, illegalNames, document.data(), &sourceError, &errors);
+    finished.release();
+}
+
+/*!
+\internal
+Drops the job if it hasn't started yet.
+*/
+void QQmlTypeLoader::ParsedSource::cancel()
+{
+    state.testAndSetOrdered(Queued, Abandoned);
+}
+
+/*!
+\internal
+Waits until the document has been parsed, and returns true. If parsing hasn't
+started yet, it is cancelled and false is returned; the caller is then better off
+parsing the document itself.
+*/
+bool QQmlTypeLoader::ParsedSource::waitForResult()
+{
+    if (state.testAndSetOrdered(Queued, Abandoned))
+        return false;
+    finished.acquire();
+    return true;
+}
+
+bool QQmlTypeLoader::ParsedSource::parse(const QQmlDataBlob::SourceCodeData &source,
+                                         const QString &url, const QSet<QString> &illegalNames,
+                                         QmlIR::Document *document, QString *sourceError,
+                                         QList<QQmlJS::DiagnosticMessage> *errors)
+{
+    document->jsModule.sourceTimeStamp = source.sourceTimeStamp();
+
+    const QString code = source.readAll(sourceError);
+    if (!sourceError->isEmpty())
+        return false;
+
+    QmlIR::IRBuilder compiler(illegalNames);
+    if (!compiler.generateFromQml(code, url, document)) {
+        *errors = compiler.errors;
+        return false;
+    }
+    return true;
+}
+
 void QQmlTypeLoader::updateTypeCacheTrimThreshold()
 {
     int size = m_typeCache.size();
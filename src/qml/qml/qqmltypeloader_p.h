@@ -58,8 +58,11 @@
 #include <QtQml/qtqmlglobal.h>
 #include <QtQml/qqmlerror.h>
 
+#include <QtCore/qatomic.h>
 #include <QtCore/qcache.h>
 #include <QtCore/qmutex.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qsharedpointer.h>
 
 #include <memory>
 
@@ -73,6 +76,11 @@ class QQmlExtensionInterface;
 class QQmlProfiler;
 class QQmlTypeLoaderThread;
 class QQmlEngine;
+class QThreadPool;
+
+namespace QmlIR {
+struct Document;
+}
 
 class Q_QML_PRIVATE_EXPORT QQmlTypeLoader
 {
@@ -163,6 +171,12 @@ public:
     bool isTypeLoaded(const QUrl &url) const;
     bool isScriptLoaded(const QUrl &url) const;
 
+    class ParsedSource;
+    bool parseInBackground(const QUrl &unNormalizedUrl);
+    QSharedPointer<ParsedSource> takeParsedSource(const QUrl &url);
+    void dropParsedSource(const QUrl &unNormalizedUrl);
+    int parseAheadCount();
+
     void lock() { m_mutex.lock(); }
     void unlock() { m_mutex.unlock(); }
 
@@ -247,6 +261,9 @@ private:
     QmldirCache m_qmldirCache;
     ImportDirCache m_importDirCache;
     ImportQmlDirCache m_importQmlDirCache;
+    QHash<QUrl, QSharedPointer<ParsedSource>> m_parsedSources;
+    int m_parseAheadCount = 0;
+    QScopedPointer<QThreadPool> m_parserPool;
 
     template<typename Loader>
     void doLoad(const Loader &loader, QQmlDataBlob *blob, Mode mode);
@@ -257,6 +274,36 @@ private:
     friend struct StaticLoader;
 };
 
+// A QML document parsed on a worker thread ahead of the type being loaded.
+class QQmlTypeLoader::ParsedSource
+{
+public:
+    ParsedSource(const QQmlDataBlob::SourceCodeData &source, const QString &url,
+                 const QSet<QString> &illegalNames, bool debugMode);
+    ~ParsedSource();
+
+    void run();
+    void cancel();
+    bool waitForResult();
+
+    static bool parse(const QQmlDataBlob::SourceCodeData &source, const QString &url,
+                      const QSet<QString> &illegalNames, QmlIR::Document *document,
+                      QString *sourceError, QList<QQmlJS::DiagnosticMessage> *errors);
+
+    QScopedPointer<QmlIR::Document> document;
+    QString sourceError;
+    QList<QQmlJS::DiagnosticMessage> errors;
+
+private:
+    enum State { Queued, Running, Abandoned };
+
+    QQmlDataBlob::SourceCodeData source;
+    QString url;
+    QSet<QString> illegalNames;
+    QAtomicInt state;
+    QSemaphore finished;
+};
+
 QT_END_NAMESPACE
 
 #endif // QQMLTYPELOADER_P_H
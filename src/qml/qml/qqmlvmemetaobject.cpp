@@ -483,6 +483,25 @@ void QQmlVMEMetaObject::writeProperty(int id, const QString& v)
     }
 }
 
+void QQmlVMEMetaObject::writeValueTypeProperty(int id, const QVariant &v)
+{
+    QV4::MemberData *md = propertyAndMethodStorageAsMemberData();
+    if (!md)
+        return;
+
+    // Typed value properties own their wrapper, it is never handed out to JavaScript.
+    // Update it in place, so that writes don't allocate on the JS heap.
+    if (const QV4::VariantObject *existing = md->data()[id].as<QV4::VariantObject>()) {
+        if (existing->d()->data().userType() == v.userType()) {
+            existing->d()->data() = v;
+            return;
+        }
+    }
+
+    QV4::Scope scope(engine);
+    QV4::Scoped<QV4::MemberData>(scope, md)->set(engine, id, engine->newVariantObject(v));
+}
+
 void QQmlVMEMetaObject::writeProperty(int id, QObject* v)
 {
     QV4::MemberData *md = propertyAndMethodStorageAsMemberData();
@@ -507,11 +526,8 @@ int QQmlVMEMetaObject::readPropertyAsInt(int id) const
     if (!md)
         return 0;
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    if (!sv->isInt32())
-        return 0;
-    return sv->integerValue();
+    const QV4::Value &value = md->data()[id];
+    return value.isInt32() ? value.integerValue() : 0;
 }
 
 bool QQmlVMEMetaObject::readPropertyAsBool(int id) const
@@ -520,11 +536,8 @@ bool QQmlVMEMetaObject::readPropertyAsBool(int id) const
     if (!md)
         return false;
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    if (!sv->isBoolean())
-        return false;
-    return sv->booleanValue();
+    const QV4::Value &value = md->data()[id];
+    return value.isBoolean() && value.booleanValue();
 }
 
 double QQmlVMEMetaObject::readPropertyAsDouble(int id) const
@@ -533,11 +546,8 @@ double QQmlVMEMetaObject::readPropertyAsDouble(int id) const
     if (!md)
         return 0.0;
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    if (!sv->isDouble())
-        return 0.0;
-    return sv->doubleValue();
+    const QV4::Value &value = md->data()[id];
+    return value.isDouble() ? value.doubleValue() : 0.0;
 }
 
 QString QQmlVMEMetaObject::readPropertyAsString(int id) const
@@ -546,9 +556,7 @@ QString QQmlVMEMetaObject::readPropertyAsString(int id) const
     if (!md)
         return QString();
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    if (QV4::String *s = sv->stringValue())
+    if (const QV4::String *s = md->data()[id].stringValue())
         return s->toQString();
     return QString();
 }
@@ -559,9 +567,7 @@ QUrl QQmlVMEMetaObject::readPropertyAsUrl(int id) const
     if (!md)
         return QUrl();
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
+    const QV4::VariantObject *v = md->data()[id].as<QV4::VariantObject>();
     if (!v || v->d()->data().userType() != QMetaType::QUrl)
         return QUrl();
     return v->d()->data().value<QUrl>();
@@ -573,9 +579,7 @@ QDate QQmlVMEMetaObject::readPropertyAsDate(int id) const
     if (!md)
         return QDate();
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
+    const QV4::VariantObject *v = md->data()[id].as<QV4::VariantObject>();
     if (!v || v->d()->data().userType() != QMetaType::QDate)
         return QDate();
     return v->d()->data().value<QDate>();
@@ -587,9 +591,7 @@ QDateTime QQmlVMEMetaObject::readPropertyAsDateTime(int id)
     if (!md)
         return QDateTime();
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
+    const QV4::VariantObject *v = md->data()[id].as<QV4::VariantObject>();
     if (!v || v->d()->data().userType() != QMetaType::QDateTime)
         return QDateTime();
     return v->d()->data().value<QDateTime>();
@@ -601,9 +603,7 @@ QSizeF QQmlVMEMetaObject::readPropertyAsSizeF(int id) const
     if (!md)
         return QSizeF();
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
+    const QV4::VariantObject *v = md->data()[id].as<QV4::VariantObject>();
     if (!v || v->d()->data().userType() != QMetaType::QSizeF)
         return QSizeF();
     return v->d()->data().value<QSizeF>();
@@ -615,9 +615,7 @@ QPointF QQmlVMEMetaObject::readPropertyAsPointF(int id) const
     if (!md)
         return QPointF();
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
+    const QV4::VariantObject *v = md->data()[id].as<QV4::VariantObject>();
     if (!v || v->d()->data().userType() != QMetaType::QPointF)
         return QPointF();
     return v->d()->data().value<QPointF>();
@@ -629,9 +627,7 @@ QObject* QQmlVMEMetaObject::readPropertyAsQObject(int id) const
     if (!md)
         return nullptr;
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::QObjectWrapper *wrapper = sv->as<QV4::QObjectWrapper>();
+    const QV4::QObjectWrapper *wrapper = md->data()[id].as<QV4::QObjectWrapper>();
     if (!wrapper)
         return nullptr;
     return wrapper->object();
@@ -659,9 +655,7 @@ QRectF QQmlVMEMetaObject::readPropertyAsRectF(int id) const
     if (!md)
         return QRectF();
 
-    QV4::Scope scope(engine);
-    QV4::ScopedValue sv(scope, *(md->data() + id));
-    const QV4::VariantObject *v = sv->as<QV4::VariantObject>();
+    const QV4::VariantObject *v = md->data()[id].as<QV4::VariantObject>();
     if (!v || v->d()->data().userType() != QMetaType::QRectF)
         return QRectF();
     return v->d()->data().value<QRectF>();
@@ -812,7 +806,9 @@ int QQmlVMEMetaObject::metaCall(QObject *o, QMetaObject::Call c, int _id, void *
                         break;
                     case QV4::CompiledData::BuiltinType::String:
                         needActivate = *reinterpret_cast<QString *>(a[0]) != readPropertyAsString(id);
-                        writeProperty(id, *reinterpret_cast<QString *>(a[0]));
+                        // Writing the same string again is common (bindings re-evaluating), don't allocate then.
+                        if (needActivate)
+                            writeProperty(id, *reinterpret_cast<QString *>(a[0]));
                         break;
                     case QV4::CompiledData::BuiltinType::Url:
                         needActivate = *reinterpret_cast<QUrl *>(a[0]) != readPropertyAsUrl(id);
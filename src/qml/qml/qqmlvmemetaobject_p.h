@@ -198,13 +198,9 @@ public:
     template<typename VariantCompatible>
     void writeProperty(int id, const VariantCompatible &v)
     {
-        QV4::MemberData *md = propertyAndMethodStorageAsMemberData();
-        if (md) {
-            QV4::Scope scope(engine);
-            QV4::Scoped<QV4::MemberData>(scope, md)->set(engine, id, engine->newVariantObject(
-                                                             QVariant::fromValue(v)));
-        }
+        writeValueTypeProperty(id, QVariant::fromValue(v));
     }
+    void writeValueTypeProperty(int id, const QVariant &v);
 
     void writeProperty(int id, QObject *v);
 
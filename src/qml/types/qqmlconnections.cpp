@@ -362,7 +362,7 @@ void QQmlConnections::connectSignalsToBindings()
                 new QQmlBoundSignal(target, signalIndex, this, qmlEngine(this));
             signal->setEnabled(d->enabled);
 
-            auto f = d->compilationUnit->runtimeFunctions[binding->value.compiledScriptIndex];
+            auto f = d->compilationUnit->runtimeFunctionAt(binding->value.compiledScriptIndex);
             QQmlBoundSignalExpression *expression =
                     ctxtdata ? new QQmlBoundSignalExpression(target, signalIndex, ctxtdata, this, f)
                              : nullptr;
@@ -41,6 +41,7 @@
 #include "qquickworkerscript_p.h"
 #include <private/qqmlengine_p.h>
 #include <private/qqmlexpression_p.h>
+#include <private/qqmltypeloader_p.h>
 
 #include <QtCore/qcoreevent.h>
 #include <QtCore/qcoreapplication.h>
@@ -64,6 +65,7 @@
 #include <private/qv4script_p.h>
 #include <private/qv4scopedvalue_p.h>
 #include <private/qv4jscall_p.h>
+#include <private/qv4executablecompilationunit_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -72,15 +74,19 @@ class WorkerDataEvent : public QEvent
 public:
     enum Type { WorkerData = QEvent::User };
 
-    WorkerDataEvent(int workerId, const QByteArray &data);
+    WorkerDataEvent(int workerId, const QByteArray &data,
+                    const QVector<QByteArray> &buffers = QVector<QByteArray>());
     virtual ~WorkerDataEvent();
 
     int workerId() const;
     QByteArray data() const;
+    QVector<QByteArray> *buffers();
 
 private:
     int m_id;
     QByteArray m_data;
+    // Contents of transferred and shared ArrayBuffers, owned by the message
+    QVector<QByteArray> m_buffers;
 };
 
 class WorkerLoadEvent : public QEvent
@@ -148,13 +154,21 @@ public:
     };
 
     QQuickWorkerScriptEnginePrivate(QQmlEngine *eng);
+    ~QQuickWorkerScriptEnginePrivate() override;
 
     QQmlEngine *qmlengine;
 
     QMutex m_lock;
     QWaitCondition m_wait;
 
+    // Created on the worker thread when the first event for a worker arrives
     QHash<int, QV4::ExecutionEngine *> workers;
+    QHash<int, QQuickWorkerScript *> owners;
+
+    // Compiled scripts, shared by all workers loading the same URL
+    QHash<QUrl, QV4::CompiledData::Unit *> compiledScripts;
+    // Number of scripts and modules a worker had to compile itself
+    int compilations;
 
     int m_nextId;
 
@@ -167,14 +181,75 @@ protected:
     bool event(QEvent *) override;
 
 private:
-    void processMessage(int, const QByteArray &);
+    QV4::ExecutionEngine *workerEngine(int);
+    QQmlRefPointer<QV4::ExecutableCompilationUnit> compiledScript(const QUrl &) const;
+    void shareCompiledScript(const QUrl &, const QQmlRefPointer<QV4::ExecutableCompilationUnit> &);
+    void processMessage(int, const QByteArray &, QVector<QByteArray> *);
     void processLoad(int, const QUrl &);
     void reportScriptException(WorkerScript *, const QQmlError &error);
 };
 
 QQuickWorkerScriptEnginePrivate::QQuickWorkerScriptEnginePrivate(QQmlEngine *engine)
-: qmlengine(engine), m_nextId(0)
+: qmlengine(engine), compilations(0), m_nextId(0)
+{
+}
+
+QQuickWorkerScriptEnginePrivate::~QQuickWorkerScriptEnginePrivate()
+{
+    // All workers are gone by now, so nothing refers to the shared units anymore.
+    for (QV4::CompiledData::Unit *unit : qAsConst(compiledScripts))
+        free(unit);
+}
+
+QV4::ExecutionEngine *QQuickWorkerScriptEnginePrivate::workerEngine(int id)
+{
+    if (QV4::ExecutionEngine *engine = workers.value(id))
+        return engine;
+
+    QMutexLocker locker(&m_lock);
+    QQuickWorkerScript *owner = owners.value(id);
+    if (!owner)
+        return nullptr;
+
+    auto *engine = new QV4::ExecutionEngine;
+    WorkerScript *script = workerScriptExtension(engine);
+    script->owner = owner;
+    script->p = this;
+
+    workers.insert(id, engine);
+    return engine;
+}
+
+QQmlRefPointer<QV4::ExecutableCompilationUnit> QQuickWorkerScriptEnginePrivate::compiledScript(
+        const QUrl &url) const
 {
+    const QV4::CompiledData::Unit *unit = compiledScripts.value(url);
+    if (!unit)
+        return nullptr;
+    return QV4::ExecutableCompilationUnit::create(QV4::CompiledData::CompilationUnit(unit));
+}
+
+void QQuickWorkerScriptEnginePrivate::shareCompiledScript(
+        const QUrl &url, const QQmlRefPointer<QV4::ExecutableCompilationUnit> &compilationUnit)
+{
+    if (!compilationUnit)
+        return;
+
+    const QV4::CompiledData::Unit *unit = compilationUnit->unitData();
+    if (unit->flags & QV4::CompiledData::Unit::StaticData)
+        return; // compiled ahead of time, every worker finds it in the same place anyway
+
+    {
+        QMutexLocker locker(&m_lock);
+        ++compilations;
+    }
+
+    // Keep a copy that outlives the engine it was compiled for. Marking it as static
+    // data stops the per-engine compilation units from freeing it.
+    auto *copy = static_cast<QV4::CompiledData::Unit *>(malloc(unit->unitSize));
+    memcpy(copy, unit, unit->unitSize);
+    copy->flags |= QV4::CompiledData::Unit::StaticData;
+    compiledScripts.insert(url, copy);
 }
 
 QV4::ReturnedValue QQuickWorkerScriptEnginePrivate::method_sendMessage(const QV4::FunctionObject *b,
@@ -185,11 +260,15 @@ QV4::ReturnedValue QQuickWorkerScriptEnginePrivate::method_sendMessage(const QV4
     Q_ASSERT(script);
 
     QV4::ScopedValue v(scope, argc > 0 ? argv[0] : QV4::Value::undefinedValue());
-    QByteArray data = QV4::Serialize::serialize(v, scope.engine);
+    QV4::ScopedValue transferList(scope, argc > 1 ? argv[1] : QV4::Value::undefinedValue());
+    QVector<QByteArray> buffers;
+    QByteArray data = QV4::Serialize::serialize(v, scope.engine, transferList, &buffers);
+    if (scope.hasException())
+        return QV4::Encode::undefined();
 
     QMutexLocker locker(&script->p->m_lock);
     if (script->owner)
-        QCoreApplication::postEvent(script->owner, new WorkerDataEvent(0, data));
+        QCoreApplication::postEvent(script->owner, new WorkerDataEvent(0, data, buffers));
 
     return QV4::Encode::undefined();
 }
@@ -198,7 +277,7 @@ bool QQuickWorkerScriptEnginePrivate::event(QEvent *event)
 {
     if (event->type() == (QEvent::Type)WorkerDataEvent::WorkerData) {
         WorkerDataEvent *workerEvent = static_cast<WorkerDataEvent *>(event);
-        processMessage(workerEvent->workerId(), workerEvent->data());
+        processMessage(workerEvent->workerId(), workerEvent->data(), workerEvent->buffers());
         return true;
     } else if (event->type() == (QEvent::Type)WorkerLoadEvent::WorkerLoad) {
         WorkerLoadEvent *workerEvent = static_cast<WorkerLoadEvent *>(event);
@@ -221,9 +300,10 @@ bool QQuickWorkerScriptEnginePrivate::event(QEvent *event)
     }
 }
 
-void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QByteArray &data)
+void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QByteArray &data,
+                                                     QVector<QByteArray> *buffers)
 {
-    QV4::ExecutionEngine *engine = workers.value(id);
+    QV4::ExecutionEngine *engine = workerEngine(id);
     if (!engine)
         return;
 
@@ -237,7 +317,7 @@ void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QByteArray &d
     if (!onmessage)
         return;
 
-    QV4::ScopedValue value(scope, QV4::Serialize::deserialize(data, engine));
+    QV4::ScopedValue value(scope, QV4::Serialize::deserialize(data, engine, buffers));
 
     QV4::JSCallData jsCallData(scope, 1);
     *jsCallData->thisObject = engine->global();
@@ -257,7 +337,7 @@ void QQuickWorkerScriptEnginePrivate::processLoad(int id, const QUrl &url)
 
     QString fileName = QQmlFile::urlToLocalFileOrQrc(url);
 
-    QV4::ExecutionEngine *engine = workers.value(id);
+    QV4::ExecutionEngine *engine = workerEngine(id);
     if (!engine)
         return;
 
@@ -265,7 +345,14 @@ void QQuickWorkerScriptEnginePrivate::processLoad(int id, const QUrl &url)
     script->source = url;
 
     if (fileName.endsWith(QLatin1String(".mjs"))) {
-        auto moduleUnit = engine->loadModule(url);
+        const QUrl moduleUrl = QQmlTypeLoader::normalize(url);
+        auto moduleUnit = compiledScript(moduleUrl);
+        if (moduleUnit) {
+            engine->injectModule(moduleUnit);
+        } else {
+            moduleUnit = engine->loadModule(moduleUrl);
+            shareCompiledScript(moduleUrl, moduleUnit);
+        }
         if (moduleUnit) {
             if (moduleUnit->instantiate(engine))
                 moduleUnit->evaluate();
@@ -276,12 +363,17 @@ void QQuickWorkerScriptEnginePrivate::processLoad(int id, const QUrl &url)
         QString error;
         QV4::Scope scope(engine);
         QScopedPointer<QV4::Script> program;
-        program.reset(QV4::Script::createFromFileOrCache(
-                          engine, /*qmlContext*/nullptr, fileName, url, &error));
-        if (program.isNull()) {
-            if (!error.isEmpty())
-                qWarning().nospace() << error;
-            return;
+        if (auto compilationUnit = compiledScript(url)) {
+            program.reset(new QV4::Script(engine, /*qmlContext*/nullptr, compilationUnit));
+        } else {
+            program.reset(QV4::Script::createFromFileOrCache(
+                              engine, /*qmlContext*/nullptr, fileName, url, &error));
+            if (program.isNull()) {
+                if (!error.isEmpty())
+                    qWarning().nospace() << error;
+                return;
+            }
+            shareCompiledScript(url, program->compilationUnit);
         }
 
         if (!engine->hasException)
@@ -300,8 +392,9 @@ void QQuickWorkerScriptEnginePrivate::reportScriptException(WorkerScript *script
         QCoreApplication::postEvent(script->owner, new WorkerErrorEvent(error));
 }
 
-WorkerDataEvent::WorkerDataEvent(int workerId, const QByteArray &data)
-: QEvent((QEvent::Type)WorkerData), m_id(workerId), m_data(data)
+WorkerDataEvent::WorkerDataEvent(int workerId, const QByteArray &data,
+                                 const QVector<QByteArray> &buffers)
+: QEvent((QEvent::Type)WorkerData), m_id(workerId), m_data(data), m_buffers(buffers)
 {
 }
 
@@ -319,6 +412,11 @@ QByteArray WorkerDataEvent::data() const
     return m_data;
 }
 
+QVector<QByteArray> *WorkerDataEvent::buffers()
+{
+    return &m_buffers;
+}
+
 WorkerLoadEvent::WorkerLoadEvent(int workerId, const QUrl &url)
 : QEvent((QEvent::Type)WorkerLoad), m_id(workerId), m_url(url)
 {
@@ -417,23 +515,21 @@ WorkerScript::WorkerScript(QV4::ExecutionEngine *engine)
 int QQuickWorkerScriptEngine::registerWorkerScript(QQuickWorkerScript *owner)
 {
     const int id = d->m_nextId++;
-    auto *engine = new QV4::ExecutionEngine;
 
-    d->m_lock.lock();
-    d->workers.insert(id, engine);
-    d->m_lock.unlock();
-
-    WorkerScript *script = workerScriptExtension(engine);
-    script->owner = owner;
-    script->p = d;
+    // The JavaScript engine is only created on the worker thread, once the
+    // worker gets something to do.
+    QMutexLocker locker(&d->m_lock);
+    d->owners.insert(id, owner);
 
     return id;
 }
 
 void QQuickWorkerScriptEngine::removeWorkerScript(int id)
 {
-    if (QV4::ExecutionEngine *engine = d->workers.value(id)) {
-        workerScriptExtension(engine)->owner = nullptr;
+    QMutexLocker locker(&d->m_lock);
+    if (d->owners.remove(id)) {
+        if (QV4::ExecutionEngine *engine = d->workers.value(id))
+            workerScriptExtension(engine)->owner = nullptr;
         QCoreApplication::postEvent(d, new WorkerRemoveEvent(id));
     }
 }
@@ -443,9 +539,18 @@ void QQuickWorkerScriptEngine::executeUrl(int id, const QUrl &url)
     QCoreApplication::postEvent(d, new WorkerLoadEvent(id, url));
 }
 
-void QQuickWorkerScriptEngine::sendMessage(int id, const QByteArray &data)
+void QQuickWorkerScriptEngine::sendMessage(int id, const QByteArray &data,
+                                           const QVector<QByteArray> &buffers)
 {
-    QCoreApplication::postEvent(d, new WorkerDataEvent(id, data));
+    QCoreApplication::postEvent(d, new WorkerDataEvent(id, data, buffers));
+}
+
+// Returns how many scripts and modules the workers compiled, rather than
+// reusing the compilation of another worker.
+int QQuickWorkerScriptEngine::compilationCount() const
+{
+    QMutexLocker locker(&d->m_lock);
+    return d->compilations;
 }
 
 void QQuickWorkerScriptEngine::run()
@@ -500,7 +605,10 @@ void QQuickWorkerScriptEngine::run()
 
     \note Each WorkerScript element will instantiate a separate JavaScript engine to ensure perfect
     isolation and thread-safety. If the impact of that results in a memory consumption that is too
-    high for your environment, then consider sharing a WorkerScript element.
+    high for your environment, then consider sharing a WorkerScript element. All WorkerScript
+    elements of a QML engine run in the same thread, the JavaScript engine of each is only created
+    once it loads a script or receives a message, and a script loaded by several WorkerScript
+    elements is only compiled once.
 
     \section3 Restrictions
 
@@ -570,7 +678,7 @@ bool QQuickWorkerScript::ready() const
 }
 
 /*!
-    \qmlmethod WorkerScript::sendMessage(jsobject message)
+    \qmlmethod WorkerScript::sendMessage(jsobject message, list transferList)
 
     Sends the given \a message to a worker script handler in another
     thread. The other worker script handler can receive this message
@@ -583,11 +691,25 @@ bool QQuickWorkerScript::ready() const
     \li boolean, number, string
     \li JavaScript objects and arrays
     \li ListModel objects (any other type of QObject* is not allowed)
+    \li ArrayBuffer, SharedArrayBuffer and typed array objects
     \endlist
 
     All objects and arrays are copied to the \c message. With the exception
-    of ListModel objects, any modifications by the other thread to an object
-    passed in \c message will not be reflected in the original object.
+    of ListModel objects and SharedArrayBuffers, any modifications by the
+    other thread to an object passed in \c message will not be reflected in
+    the original object.
+
+    ArrayBuffers listed in the optional \a transferList are moved to the
+    other thread instead of being copied. They, and any typed arrays viewing
+    them, become detached and unusable in the sending thread. The same
+    transfer list can be passed to \tt WorkerScript.sendMessage() in the
+    worker script.
+
+    \code
+    var pixels = new Uint8Array(width * height * 4);
+    // ... fill pixels ...
+    myWorker.sendMessage({ 'pixels': pixels }, [ pixels.buffer ]);
+    \endcode
 */
 void QQuickWorkerScript::sendMessage(QQmlV4Function *args)
 {
@@ -600,8 +722,16 @@ void QQuickWorkerScript::sendMessage(QQmlV4Function *args)
     QV4::ScopedValue argument(scope, QV4::Value::undefinedValue());
     if (args->length() != 0)
         argument = (*args)[0];
+    QV4::ScopedValue transferList(scope, QV4::Value::undefinedValue());
+    if (args->length() > 1)
+        transferList = (*args)[1];
+
+    QVector<QByteArray> buffers;
+    QByteArray data = QV4::Serialize::serialize(argument, scope.engine, transferList, &buffers);
+    if (scope.hasException())
+        return;
 
-    m_engine->sendMessage(m_scriptId, QV4::Serialize::serialize(argument, scope.engine));
+    m_engine->sendMessage(m_scriptId, data, buffers);
 }
 
 void QQuickWorkerScript::classBegin()
@@ -655,7 +785,8 @@ bool QQuickWorkerScript::event(QEvent *event)
         if (QQmlEngine *engine = qmlEngine(this)) {
             QV4::ExecutionEngine *v4 = engine->handle();
             WorkerDataEvent *workerEvent = static_cast<WorkerDataEvent *>(event);
-            emit message(QJSValue(v4, QV4::Serialize::deserialize(workerEvent->data(), v4)));
+            emit message(QJSValue(v4, QV4::Serialize::deserialize(workerEvent->data(), v4,
+                                                                  workerEvent->buffers())));
         }
         return true;
     } else if (event->type() == (QEvent::Type)WorkerErrorEvent::WorkerError) {
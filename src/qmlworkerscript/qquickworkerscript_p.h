@@ -58,13 +58,14 @@
 #include <QtCore/qthread.h>
 #include <QtQml/qjsvalue.h>
 #include <QtCore/qurl.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
 
 class QQuickWorkerScript;
 class QQuickWorkerScriptEnginePrivate;
-class QQuickWorkerScriptEngine : public QThread
+class Q_AUTOTEST_EXPORT QQuickWorkerScriptEngine : public QThread
 {
 Q_OBJECT
 public:
@@ -74,7 +75,9 @@ public:
     int registerWorkerScript(QQuickWorkerScript *);
     void removeWorkerScript(int);
     void executeUrl(int, const QUrl &);
-    void sendMessage(int, const QByteArray &);
+    void sendMessage(int, const QByteArray &, const QVector<QByteArray> &);
+
+    int compilationCount() const;
 
 protected:
     void run() override;
@@ -47,6 +47,12 @@
 #endif
 #include <private/qv4objectproto_p.h>
 #include <private/qv4qobjectwrapper_p.h>
+#include <private/qv4arraybuffer_p.h>
+#include <private/qv4typedarray_p.h>
+#include <private/qv4mm_p.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -64,7 +70,23 @@ using namespace QV4;
 //    + Number
 //    + Date
 //    + RegExp
+//    + ArrayBuffer, SharedArrayBuffer
+//    + TypedArray
 // <quint8 type><quint24 size><data>
+//
+// ArrayBuffers are copied, unless they are listed in the transfer list, in
+// which case their contents are handed over to the receiver and the sender's
+// buffer is detached. SharedArrayBuffers share their contents. Handed over
+// and shared contents travel next to the stream, in the message's buffer
+// list, and the stream only holds their index in it. This way they are
+// released with the message, even if it is never delivered. Every buffer is
+// written once per message; further
+// references to it (e.g. from several typed arrays) are written as
+// WorkerArrayBufferRef with the buffer's index in the message.
+//
+// Plain objects that share an internal class are written as
+// WorkerShapedObject: the first one carries the property names, all others
+// only their values.
 
 enum Type {
     WorkerUndefined,
@@ -82,11 +104,61 @@ enum Type {
     WorkerRegexp,
     WorkerListModel,
     WorkerUrl,
+    WorkerArrayBuffer,
+    WorkerArrayBufferRef,
+    WorkerTypedArray,
+    WorkerNewShapedObject,
+    WorkerShapedObject,
 #if QT_CONFIG(qml_sequence_object)
     WorkerSequence
 #endif
 };
 
+enum BufferMode {
+    CopiedBuffer,
+    TransferredBuffer,
+    SharedBuffer
+};
+
+struct Serialize::SerializeState
+{
+    SerializeState(ExecutionEngine *engine)
+        : engine(engine), scope(engine), shapeKeys(scope, engine->newArrayObject())
+        , shapeObjects(scope, engine->newArrayObject())
+    {}
+
+    ExecutionEngine *engine;
+    Scope scope;
+    ScopedArrayObject shapeKeys;
+    // The first object of each shape. Its internal class is only the one in
+    // shapes as long as the object still has it, as getters can change it.
+    ScopedArrayObject shapeObjects;
+    QVector<Heap::SharedArrayBuffer *> transfer;
+    QHash<Heap::SharedArrayBuffer *, quint32> buffers;
+    QHash<Heap::InternalClass *, quint32> shapes;
+    // Contents handed over or shared with the receiver. If null, all buffers are copied.
+    QVector<QByteArray> *messageBuffers = nullptr;
+};
+
+struct Serialize::DeserializeState
+{
+    DeserializeState(ExecutionEngine *engine)
+        : engine(engine), scope(engine)
+        , buffers(scope, engine->newArrayObject())
+        , shapeKeys(scope, engine->newArrayObject())
+        , shapeTemplates(scope, engine->newArrayObject())
+    {}
+
+    ExecutionEngine *engine;
+    Scope scope;
+    ScopedArrayObject buffers;
+    QVector<QByteArray> *messageBuffers = nullptr;
+    ScopedArrayObject shapeKeys;
+    // The first object of each shape, if its internal class stores the
+    // properties in message order and can be reused for the others.
+    ScopedArrayObject shapeTemplates;
+};
+
 static inline quint32 valueheader(Type type, quint32 size = 0)
 {
     return quint8(type) << 24 | (size & 0xFFFFFF);
@@ -166,8 +238,60 @@ static inline void serializeString(QByteArray &data, const QString &str, Type ty
 // XXX TODO: Check that worker script is exception safe in the case of
 // serialization/deserialization failures
 
-void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine *engine)
+void Serialize::serializeArrayBuffer(QByteArray &data, const QV4::Value &v, SerializeState &state)
 {
+    const SharedArrayBuffer *buffer = v.as<SharedArrayBuffer>();
+    Q_ASSERT(buffer);
+    Heap::SharedArrayBuffer *d = buffer->d();
+
+    const auto it = state.buffers.constFind(d);
+    if (it != state.buffers.constEnd()) {
+        push(data, valueheader(WorkerArrayBufferRef, *it));
+        return;
+    }
+
+    if (buffer->isDetachedBuffer() || state.buffers.size() > 0xFFFFFF) {
+        push(data, valueheader(WorkerUndefined));
+        return;
+    }
+    state.buffers.insert(d, state.buffers.size());
+
+    const bool shared = buffer->isSharedArrayBuffer();
+    if (state.messageBuffers && (shared || state.transfer.contains(d))
+            && state.messageBuffers->size() < 0xFFFFFF) {
+        QByteArray contents;
+        if (!shared && d->data->ref.isShared()) {
+            // Someone else, e.g. a QByteArray handed out to C++, still refers to the
+            // contents. The receiver writes to them in place, so give it a copy.
+            contents = QByteArray(d->data->data(), int(buffer->byteLength()));
+        } else {
+            d->data->ref.ref();
+            QByteArrayDataPtr ptr = { d->data };
+            contents = QByteArray(ptr);
+        }
+        // Transferred buffers are detached from the sender once the whole
+        // message is written.
+        reserve(data, 2 * sizeof(quint32));
+        push(data, valueheader(WorkerArrayBuffer, shared ? SharedBuffer : TransferredBuffer));
+        push(data, quint32(state.messageBuffers->size()));
+        state.messageBuffers->append(contents);
+        return;
+    }
+
+    const quint32 length = buffer->byteLength();
+    const int size = ALIGN(length);
+    reserve(data, 2 * sizeof(quint32) + size);
+    push(data, valueheader(WorkerArrayBuffer, CopiedBuffer));
+    push(data, length);
+
+    int offset = data.size();
+    data.resize(data.size() + size);
+    memcpy(data.data() + offset, d->data->data(), length);
+}
+
+void Serialize::serialize(QByteArray &data, const QV4::Value &v, SerializeState &state)
+{
+    ExecutionEngine *engine = state.engine;
     QV4::Scope scope(engine);
 
     if (v.isEmpty()) {
@@ -194,7 +318,7 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
         push(data, valueheader(WorkerArray, length));
         ScopedValue val(scope);
         for (uint ii = 0; ii < length; ++ii)
-            serialize(data, (val = array->get(ii)), engine);
+            serialize(data, (val = array->get(ii)), state);
     } else if (v.isInteger()) {
         reserve(data, 2 * sizeof(quint32));
         push(data, valueheader(WorkerInt32));
@@ -244,6 +368,19 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
         }
         // No other QObject's are allowed to be sent
         push(data, valueheader(WorkerUndefined));
+    } else if (v.as<SharedArrayBuffer>()) {
+        serializeArrayBuffer(data, v, state);
+    } else if (const TypedArray *typedArray = v.as<TypedArray>()) {
+        Heap::TypedArray *d = typedArray->d();
+        if (!d->buffer || d->buffer->isDetachedBuffer()) {
+            push(data, valueheader(WorkerUndefined));
+            return;
+        }
+        reserve(data, 3 * sizeof(quint32));
+        push(data, valueheader(WorkerTypedArray, d->arrayType));
+        push(data, quint32(d->byteOffset));
+        push(data, quint32(d->byteLength));
+        serializeArrayBuffer(data, Value::fromHeapObject(d->buffer), state);
     } else if (const Object *o = v.as<Object>()) {
 #if QT_CONFIG(qml_sequence_object)
         if (o->isListType()) {
@@ -256,10 +393,10 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
             }
             reserve(data, sizeof(quint32) + length * sizeof(quint32));
             push(data, valueheader(WorkerSequence, length));
-            serialize(data, QV4::Value::fromInt32(QV4::SequencePrototype::metaTypeForSequence(o)), engine); // sequence type
+            serialize(data, QV4::Value::fromInt32(QV4::SequencePrototype::metaTypeForSequence(o)), state); // sequence type
             ScopedValue val(scope);
             for (uint ii = 0; ii < seqLength; ++ii)
-                serialize(data, (val = o->get(ii)), engine); // sequence elements
+                serialize(data, (val = o->get(ii)), state); // sequence elements
 
             return;
         }
@@ -272,25 +409,58 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
 
         // regular object
         QV4::ScopedValue val(scope, v);
+        QV4::ScopedValue s(scope);
+        const bool plainObject = o->vtable() == QV4::Object::staticVTable() && !o->arrayData();
+        if (plainObject) {
+            const auto it = state.shapes.constFind(o->internalClass());
+            QV4::ScopedObject shapeObject(scope);
+            if (it != state.shapes.constEnd())
+                shapeObject = state.shapeObjects->get(*it);
+            // A stale entry can refer to a class that was freed, and its address reused
+            if (shapeObject && shapeObject->internalClass() == o->internalClass()) {
+                // Same property names as an object written before, only write the values
+                QV4::ScopedArrayObject properties(scope, state.shapeKeys->get(*it));
+                quint32 length = properties->getLength();
+                reserve(data, sizeof(quint32) + length * sizeof(quint32));
+                push(data, valueheader(WorkerShapedObject, *it));
+                for (quint32 ii = 0; ii < length; ++ii) {
+                    s = properties->get(ii);
+                    val = o->get(s->as<String>());
+                    if (scope.hasException())
+                        scope.engine->catchException();
+
+                    serialize(data, val, state);
+                }
+                return;
+            }
+        }
+
         QV4::ScopedArrayObject properties(scope, QV4::ObjectPrototype::getOwnPropertyNames(engine, val));
         quint32 length = properties->getLength();
         if (length > 0xFFFFFF) {
             push(data, valueheader(WorkerUndefined));
             return;
         }
-        push(data, valueheader(WorkerObject, length));
+        const quint32 shape = state.shapeKeys->getLength();
+        if (plainObject && shape < 0xFFFFFF) {
+            state.shapes.insert(o->internalClass(), shape);
+            state.shapeKeys->put(shape, properties);
+            state.shapeObjects->put(shape, o);
+            push(data, valueheader(WorkerNewShapedObject, length));
+        } else {
+            push(data, valueheader(WorkerObject, length));
+        }
 
-        QV4::ScopedValue s(scope);
         for (quint32 ii = 0; ii < length; ++ii) {
             s = properties->get(ii);
-            serialize(data, s, engine);
+            serialize(data, s, state);
 
             QV4::String *str = s->as<String>();
             val = o->get(str);
             if (scope.hasException())
                 scope.engine->catchException();
 
-            serialize(data, val, engine);
+            serialize(data, val, state);
         }
         return;
     } else {
@@ -333,11 +503,12 @@ Q_DECLARE_METATYPE(VariantRef)
 Q_DECLARE_METATYPE(QV4::ExecutionEngine *)
 QT_BEGIN_NAMESPACE
 
-ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
+ReturnedValue Serialize::deserialize(const char *&data, DeserializeState &state)
 {
     quint32 header = popUint32(data);
     Type type = headertype(header);
 
+    ExecutionEngine *engine = state.engine;
     Scope scope(engine);
 
     switch (type) {
@@ -368,7 +539,7 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
         ScopedArrayObject a(scope, engine->newArrayObject());
         ScopedValue v(scope);
         for (quint32 ii = 0; ii < size; ++ii) {
-            v = deserialize(data, engine);
+            v = deserialize(data, state);
             a->put(ii, v);
         }
         return a.asReturnedValue();
@@ -381,13 +552,107 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
         ScopedString n(scope);
         ScopedValue value(scope);
         for (quint32 ii = 0; ii < size; ++ii) {
-            name = deserialize(data, engine);
-            value = deserialize(data, engine);
+            name = deserialize(data, state);
+            value = deserialize(data, state);
             n = name->asReturnedValue();
             o->put(n, value);
         }
         return o.asReturnedValue();
     }
+    case WorkerNewShapedObject:
+    {
+        quint32 size = headersize(header);
+        ScopedObject o(scope, engine->newObject());
+        ScopedArrayObject names(scope, engine->newArrayObject(size));
+        ScopedValue name(scope);
+        ScopedString n(scope);
+        ScopedValue value(scope);
+        for (quint32 ii = 0; ii < size; ++ii) {
+            name = deserialize(data, state);
+            value = deserialize(data, state);
+            n = name->asReturnedValue();
+            names->put(ii, n);
+            o->put(n, value);
+        }
+
+        // Objects of the same shape can be created from our internal class
+        // directly, if it holds exactly the properties we put, in that order.
+        Heap::InternalClass *ic = o->internalClass();
+        bool reusable = !o->arrayData() && ic->size == size;
+        for (quint32 ii = 0; reusable && ii < size; ++ii) {
+            n = names->get(ii);
+            const InternalClassEntry entry = ic->find(n->toPropertyKey());
+            reusable = entry.isValid() && entry.index == ii && !entry.attributes.isAccessor()
+                    && entry.attributes.isWritable();
+        }
+
+        const uint shape = state.shapeKeys->getLength();
+        state.shapeKeys->put(shape, names);
+        value = reusable ? o->asReturnedValue() : Encode::undefined();
+        state.shapeTemplates->put(shape, value);
+        return o.asReturnedValue();
+    }
+    case WorkerShapedObject:
+    {
+        const quint32 shape = headersize(header);
+        ScopedArrayObject names(scope, state.shapeKeys->get(shape));
+        ScopedObject shapeTemplate(scope, state.shapeTemplates->get(shape));
+        const quint32 size = names->getLength();
+        ScopedObject o(scope, shapeTemplate ? engine->newObject(shapeTemplate->internalClass())
+                                            : engine->newObject());
+        ScopedString n(scope);
+        ScopedValue value(scope);
+        for (quint32 ii = 0; ii < size; ++ii) {
+            value = deserialize(data, state);
+            if (shapeTemplate) {
+                o->setProperty(ii, *value);
+            } else {
+                n = names->get(ii);
+                o->put(n, value);
+            }
+        }
+        return o.asReturnedValue();
+    }
+    case WorkerArrayBuffer:
+    {
+        Scoped<SharedArrayBuffer> buffer(scope);
+        if (headersize(header) == CopiedBuffer) {
+            quint32 length = popUint32(data);
+            buffer = engine->newArrayBuffer(QByteArray(data, int(length)));
+            data += ALIGN(length);
+        } else {
+            const quint32 index = popUint32(data);
+            if (state.messageBuffers && index < quint32(state.messageBuffers->size())) {
+                // Take the contents out of the message, so that a transferred
+                // buffer is not shared with it anymore.
+                QByteArray array;
+                qSwap(array, (*state.messageBuffers)[int(index)]);
+                if (headersize(header) == SharedBuffer)
+                    buffer = engine->memoryManager->allocate<SharedArrayBuffer>(array);
+                else
+                    buffer = engine->newArrayBuffer(array);
+            }
+        }
+        state.buffers->put(state.buffers->getLength(), buffer);
+        return buffer.asReturnedValue();
+    }
+    case WorkerArrayBufferRef:
+        return state.buffers->get(headersize(header));
+    case WorkerTypedArray:
+    {
+        const quint32 arrayType = headersize(header);
+        const quint32 byteOffset = popUint32(data);
+        const quint32 byteLength = popUint32(data);
+        Scoped<ArrayBuffer> buffer(scope, deserialize(data, state));
+        if (!buffer || arrayType >= NTypedArrayTypes)
+            return QV4::Encode::undefined();
+
+        Scoped<TypedArray> array(scope, TypedArray::create(engine, TypedArrayType(arrayType)));
+        array->d()->buffer.set(engine, buffer->d());
+        array->d()->byteOffset = byteOffset;
+        array->d()->byteLength = byteLength;
+        return array.asReturnedValue();
+    }
     case WorkerInt32:
         return QV4::Encode((qint32)popUint32(data));
     case WorkerUint32:
@@ -426,12 +691,12 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
         bool succeeded = false;
         quint32 length = headersize(header);
         quint32 seqLength = length - 1;
-        value = deserialize(data, engine);
+        value = deserialize(data, state);
         int sequenceType = value->integerValue();
         ScopedArrayObject array(scope, engine->newArrayObject());
         array->arrayReserve(seqLength);
         for (quint32 ii = 0; ii < seqLength; ++ii) {
-            value = deserialize(data, engine);
+            value = deserialize(data, state);
             array->arrayPut(ii, value);
         }
         array->setArrayLengthUnchecked(seqLength);
@@ -446,15 +711,71 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
 
 QByteArray Serialize::serialize(const QV4::Value &value, ExecutionEngine *engine)
 {
+    SerializeState state(engine);
+    QByteArray rv;
+    serialize(rv, value, state);
+    return rv;
+}
+
+/*
+    Serializes \a value like the overload above. The contents of the
+    ArrayBuffers listed in \a transferList, and of all SharedArrayBuffers, are
+    appended to \a buffers instead of being copied into the stream. The
+    transferred ArrayBuffers are detached once the message has been written.
+    Throws a TypeError and returns an empty QByteArray if \a transferList is
+    neither undefined nor an array of distinct, non-detached ArrayBuffers.
+*/
+QByteArray Serialize::serialize(const QV4::Value &value, ExecutionEngine *engine,
+                                const QV4::Value &transferList, QVector<QByteArray> *buffers)
+{
+    SerializeState state(engine);
+    state.messageBuffers = buffers;
+    if (!transferList.isUndefined()) {
+        Scope scope(engine);
+        ScopedArrayObject list(scope, transferList);
+        if (!list) {
+            engine->throwTypeError(QStringLiteral("Transfer list must be an array"));
+            return QByteArray();
+        }
+        Scoped<ArrayBuffer> buffer(scope);
+        const uint length = list->getLength();
+        for (uint ii = 0; ii < length; ++ii) {
+            buffer = list->get(ii);
+            if (!buffer || buffer->isDetachedBuffer() || state.transfer.contains(buffer->d())) {
+                engine->throwTypeError(QStringLiteral("Transfer list may only contain distinct, non-detached ArrayBuffers"));
+                return QByteArray();
+            }
+            state.transfer.append(buffer->d());
+        }
+    }
+
     QByteArray rv;
-    serialize(rv, value, engine);
+    serialize(rv, value, state);
+
+    for (Heap::SharedArrayBuffer *buffer : qAsConst(state.transfer))
+        static_cast<Heap::ArrayBuffer *>(buffer)->detachArrayBuffer();
     return rv;
 }
 
 ReturnedValue Serialize::deserialize(const QByteArray &data, ExecutionEngine *engine)
 {
+    DeserializeState state(engine);
+    const char *stream = data.constData();
+    return deserialize(stream, state);
+}
+
+/*
+    Deserializes a message written by the overload of serialize() taking a
+    transfer list. The buffer contents the message refers to are taken out of
+    \a buffers.
+*/
+ReturnedValue Serialize::deserialize(const QByteArray &data, ExecutionEngine *engine,
+                                     QVector<QByteArray> *buffers)
+{
+    DeserializeState state(engine);
+    state.messageBuffers = buffers;
     const char *stream = data.constData();
-    return deserialize(stream, engine);
+    return deserialize(stream, state);
 }
 
 QT_END_NAMESPACE
@@ -52,6 +52,7 @@
 //
 
 #include <QtCore/qbytearray.h>
+#include <QtCore/qvector.h>
 #include <private/qv4value_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -62,11 +63,19 @@ class Serialize {
 public:
 
     static QByteArray serialize(const Value &, ExecutionEngine *);
+    static QByteArray serialize(const Value &, ExecutionEngine *, const Value &transferList,
+                                QVector<QByteArray> *buffers);
     static ReturnedValue deserialize(const QByteArray &, ExecutionEngine *);
+    static ReturnedValue deserialize(const QByteArray &, ExecutionEngine *,
+                                     QVector<QByteArray> *buffers);
 
 private:
-    static void serialize(QByteArray &, const Value &, ExecutionEngine *);
-    static ReturnedValue deserialize(const char *&, ExecutionEngine *);
+    struct SerializeState;
+    struct DeserializeState;
+
+    static void serialize(QByteArray &, const Value &, SerializeState &);
+    static void serializeArrayBuffer(QByteArray &, const Value &, SerializeState &);
+    static ReturnedValue deserialize(const char *&, DeserializeState &);
 };
 
 }
@@ -293,7 +293,7 @@ void QQuickPropertyChangesPrivate::decodeBinding(const QString &propertyPrefix,
             QQuickReplaceSignalHandler *handler = new QQuickReplaceSignalHandler;
             handler->property = prop;
             handler->expression.take(new QQmlBoundSignalExpression(object, QQmlPropertyPrivate::get(prop)->signalIndex(),
-                                                                   QQmlContextData::get(qmlContext(q)), object, compilationUnit->runtimeFunctions.at(binding->value.compiledScriptIndex)));
+                                                                   QQmlContextData::get(qmlContext(q)), object, compilationUnit->runtimeFunctionAt(binding->value.compiledScriptIndex)));
             signalReplacements << handler;
             return;
         }
@@ -478,7 +478,7 @@ QQuickPropertyChanges::ActionList QQuickPropertyChanges::actions()
                 QV4::Scope scope(qmlEngine(this)->handle());
                 QV4::Scoped<QV4::QmlContext> qmlContext(scope, QV4::QmlContext::create(scope.engine->rootContext(), context, object()));
                 newBinding = QQmlBinding::create(&QQmlPropertyPrivate::get(prop)->core,
-                                                 d->compilationUnit->runtimeFunctions.at(e.id), object(), context, qmlContext);
+                                                 d->compilationUnit->runtimeFunctionAt(e.id), object(), context, qmlContext);
             }
             if (!newBinding)
                 newBinding = QQmlBinding::create(&QQmlPropertyPrivate::get(prop)->core,
@@ -40,6 +40,7 @@
 #include <stdlib.h>
 #include <private/qv4alloca_p.h>
 #include <private/qjsvalue_p.h>
+#include <private/qv4regexp_p.h>
 #include <QScopeGuard>
 
 #ifdef Q_CC_MSVC
@@ -134,6 +135,13 @@ private slots:
     void reentrancy_objectCreation();
     void jsIncDecNonObjectProperty();
     void JSONparse();
+    void JSONroundTrip_data();
+    void JSONroundTrip();
+    void mapAndSetLookups();
+    void mapAndSetRemoval();
+    void stringBuilding();
+    void constantFolding();
+    void arraySortStableAndNative();
     void arraySort();
     void lookupOnDisappearingProperty();
     void arrayConcat();
@@ -158,6 +166,7 @@ private slots:
 
     void regexpLastMatch();
     void regexpLastIndex();
+    void regexpLiteralPatterns();
     void indexedAccesses();
 
     void prototypeChainGc();
@@ -264,7 +273,9 @@ private slots:
     void arrayIncludesWithLargeArray();
     void printCircularArray();
     void typedArraySet();
+    void typedArrayBulkOperations();
     void dataViewCtor();
+    void literalsCreatedOnFirstUse();
 
     void uiLanguage();
 
@@ -3195,6 +3206,360 @@ void tst_QJSEngine::JSONparse()
     QVERIFY(ret.isObject());
 }
 
+void tst_QJSEngine::JSONroundTrip_data()
+{
+    QTest::addColumn<QString>("expression");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("compact") << QStringLiteral(R"(JSON.stringify(JSON.parse(JSON.stringify({a: 1, b: [1, 2.5, -3, "x\ny", true, null, {}], c: {d: "\u0001\"q\\", e: []}}))))")
+                             << QStringLiteral(R"({"a":1,"b":[1,2.5,-3,"x\ny",true,null,{}],"c":{"d":"\u0001\"q\\","e":[]}})");
+    QTest::newRow("indented") << QStringLiteral("JSON.stringify({a: [1, {}], b: {c: 'd'}}, null, 2)")
+                              << QStringLiteral("{\n  \"a\": [\n    1,\n    {}\n  ],\n  \"b\": {\n    \"c\": \"d\"\n  }\n}");
+    QTest::newRow("skipped members") << QStringLiteral("JSON.stringify({a: undefined, b: function() {}, c: 1})")
+                                     << QStringLiteral("{\"c\":1}");
+    QTest::newRow("undefined elements") << QStringLiteral("JSON.stringify([undefined, function() {}])")
+                                        << QStringLiteral("[null,null]");
+    QTest::newRow("integers") << QStringLiteral("JSON.stringify(JSON.parse('[1234567, -1234567, 123456789012, 0, -0, 1e3]'))")
+                              << QStringLiteral("[1234567,-1234567,123456789012,0,0,1000]");
+    QTest::newRow("repeated keys") << QStringLiteral("JSON.stringify(JSON.parse('[{\"k\":1,\"0\":2},{\"k\":3,\"0\":4}]'))")
+                                   << QStringLiteral("[{\"0\":2,\"k\":1},{\"0\":4,\"k\":3}]");
+    QTest::newRow("control character") << QStringLiteral("try { JSON.parse('\"a\\u0001\"'); 'parsed' } catch (e) { 'error' }")
+                                       << QStringLiteral("error");
+}
+
+void tst_QJSEngine::JSONroundTrip()
+{
+    QFETCH(QString, expression);
+    QFETCH(QString, expected);
+
+    QJSEngine eng;
+    QJSValue ret = eng.evaluate(expression);
+    QVERIFY2(!ret.isError(), qPrintable(ret.toString()));
+    QCOMPARE(ret.toString(), expected);
+}
+
+void tst_QJSEngine::mapAndSetLookups()
+{
+    QJSEngine eng;
+    QJSValue ret = eng.evaluate(QStringLiteral(R"(
+        (function() {
+            var map = new Map;
+            var objects = [];
+            for (var i = 0; i < 5000; ++i) {
+                map.set(i, 'int' + i);
+                map.set('s' + i, i);
+                objects.push({ i: i });
+                map.set(objects[i], i);
+            }
+            if (map.size !== 15000)
+                return 'size ' + map.size;
+
+            // SameValueZero: doubles with integral values, -0 and NaN
+            if (map.get(42.0) !== 'int42' || map.get(0.5 + 41.5) !== 'int42')
+                return 'double key';
+            map.set(-0, 'zero');
+            if (map.get(0) !== 'zero' || map.size !== 15000)
+                return 'zero key';
+            map.set(NaN, 'nan');
+            if (map.get(0 / 0) !== 'nan')
+                return 'nan key';
+            map.delete(NaN);
+
+            for (var i = 0; i < 5000; i += 2) {
+                if (!map.delete(i) || !map.delete('s' + i) || !map.delete(objects[i]))
+                    return 'delete ' + i;
+            }
+            for (var i = 0; i < 5000; ++i) {
+                var expected = (i % 2) ? i : undefined;
+                if (map.get(objects[i]) !== expected || map.get('s' + i) !== expected
+                        || map.has(i) !== (i % 2 === 1))
+                    return 'lookup after delete ' + i;
+            }
+
+            // Insertion order is kept
+            var keys = Array.from(map.keys());
+            if (keys[0] !== 1 || keys[1] !== 's1' || keys[2] !== objects[1] || keys.length !== 7500)
+                return 'order ' + keys.slice(0, 3);
+
+            var set = new Set;
+            for (var i = 0; i < 5000; ++i)
+                set.add('k' + (i % 1000));
+            if (set.size !== 1000 || !set.has('k999') || set.has('k1000'))
+                return 'set';
+
+            map.clear();
+            if (map.size !== 0 || map.has(1) || map.get('s1') !== undefined)
+                return 'clear';
+            map.set('a', 1);
+            return map.get('a') === 1 ? 'ok' : 'after clear';
+        })()
+    )"));
+    QCOMPARE(ret.toString(), QStringLiteral("ok"));
+}
+
+void tst_QJSEngine::mapAndSetRemoval()
+{
+    QJSEngine eng;
+    QJSValue ret = eng.evaluate(QStringLiteral(R"(
+        (function() {
+            // Removing an entry that was already visited must not skip the next one
+            var map = new Map([[1, 'a'], [2, 'b'], [3, 'c'], [4, 'd']]);
+            var seen = [];
+            for (var [k] of map) {
+                seen.push(k);
+                if (k === 2)
+                    map.delete(1);
+            }
+            if (seen.join() !== '1,2,3,4')
+                return 'iteration ' + seen;
+
+            seen = [];
+            var set = new Set(['a', 'b', 'c', 'd']);
+            set.forEach(function(v) {
+                seen.push(v);
+                if (v === 'b') {
+                    set.delete('a');
+                    set.delete('c');
+                }
+            });
+            if (seen.join() !== 'a,b,d' || set.size !== 2)
+                return 'forEach ' + seen;
+
+            // Adding an entry to a full table can compact it while iterating
+            map = new Map([[1, 1], [2, 2], [3, 3], [4, 4], [5, 5], [6, 6], [7, 7], [8, 8]]);
+            var keys = map.keys();
+            seen = [];
+            for (var i = 0; i < 5; ++i)
+                seen.push(keys.next().value);
+            for (var i = 1; i <= 4; ++i)
+                map.delete(i);
+            map.set('x', 1);
+            for (var k of keys)
+                seen.push(k);
+            if (seen.join() !== '1,2,3,4,5,6,7,8,x')
+                return 'compacting iteration ' + seen;
+
+            seen = [];
+            set = new Set(['a', 'b', 'c', 'd', 'e', 'f', 'g', 'h']);
+            set.forEach(function(v) {
+                seen.push(v);
+                if (v === 'e') {
+                    ['a', 'b', 'c', 'd'].forEach(function(d) { set.delete(d); });
+                    set.add('x');
+                    set.add('a');
+                }
+            });
+            if (seen.join() !== 'a,b,c,d,e,f,g,h,x,a' || set.size !== 6)
+                return 'compacting forEach ' + seen;
+
+            // Use the table as a queue, so that removed entries pile up at the front
+            var queue = new Set;
+            for (var i = 0; i < 20000; ++i) {
+                queue.add(i);
+                if (i >= 10 && !queue.delete(i - 10))
+                    return 'queue delete ' + i;
+            }
+            var rest = Array.from(queue);
+            if (queue.size !== 10 || rest[0] !== 19990 || rest[9] !== 19999 || queue.has(19989))
+                return 'queue ' + rest;
+
+            var big = new Map;
+            for (var i = 0; i < 20000; ++i)
+                big.set('k' + i, i);
+            for (var i = 0; i < 19999; ++i)
+                big.delete('k' + i);
+            if (big.size !== 1 || big.get('k19999') !== 19999 || Array.from(big.keys()).join() !== 'k19999')
+                return 'big';
+            big.delete('k19999');
+            big.set('x', 1);
+            return (big.size === 1 && big.get('x') === 1) ? 'ok' : 'after emptying';
+        })()
+    )"));
+    QCOMPARE(ret.toString(), QStringLiteral("ok"));
+}
+
+void tst_QJSEngine::stringBuilding()
+{
+    QJSEngine eng;
+    QJSValue ret = eng.evaluate(QStringLiteral(R"(
+        (function() {
+            var s = '';
+            var parts = [];
+            var snapshots = [];
+            for (var i = 0; i < 3000; ++i) {
+                var line = 'line ' + i + '\n';
+                s += line;
+                parts.push(line);
+                // Looking at the string flattens it in every iteration
+                if (s.indexOf(line) !== s.length - line.length)
+                    return 'indexOf ' + i;
+                if (i % 500 === 0)
+                    snapshots.push(s);
+            }
+            if (s !== parts.join(''))
+                return 'content';
+
+            // Earlier values are unaffected by later appends
+            for (var k = 0; k < snapshots.length; ++k) {
+                if (snapshots[k] !== parts.slice(0, k * 500 + 1).join(''))
+                    return 'snapshot ' + k;
+            }
+
+            var prefix = snapshots[1];
+            var a = prefix + 'a';
+            var b = prefix + 'b';
+            if (a.charAt(a.length - 1) !== 'a' || b.slice(-1) !== 'b' || a.slice(0, -1) !== prefix)
+                return 'branch';
+
+            var twice = a + a;
+            if (twice.length !== 2 * a.length || twice.indexOf('aline 0') === -1 || twice.lastIndexOf(a) !== a.length)
+                return 'self append';
+
+            var sub = s.substring(7, 12) + s.substring(0, 4);
+            var big = sub + s;
+            if (big.indexOf('line 2999') !== big.length - 10 || sub !== 'line line')
+                return 'substring ' + sub;
+
+            var large = new Array(2000).join('x');
+            var other = new Array(2000).join('x');
+            if (large !== other || large === other + 'x')
+                return 'large comparison';
+            return 'ok';
+        })()
+    )"));
+    QCOMPARE(ret.toString(), QStringLiteral("ok"));
+}
+
+void tst_QJSEngine::constantFolding()
+{
+    QJSEngine eng;
+    QJSValue ret = eng.evaluate(QStringLiteral(R"(
+        (function() {
+            var x = 5;
+            x;
+            x = x;
+            x = x;
+            var y = true;
+            y = null;
+            return [1 + 2, 7 - 10, 6 * 7, 1 / 0, 1 / (-1 % 1), 5.5 % 2, 1 << 31, -1 >>> 0,
+                    -16 >> 2, 0.1 + 0.2, (1) + (2 * 3), 1 / (0 * -1), 2 ** 10,
+                    null == undefined, 1 + '2', x, y];
+        })()
+    )"));
+    QVERIFY(ret.isArray());
+    QCOMPARE(ret.property(0).toNumber(), 3.);
+    QCOMPARE(ret.property(1).toNumber(), -3.);
+    QCOMPARE(ret.property(2).toNumber(), 42.);
+    QCOMPARE(ret.property(3).toNumber(), qInf());
+    QCOMPARE(ret.property(4).toNumber(), -qInf());
+    QCOMPARE(ret.property(5).toNumber(), 1.5);
+    QCOMPARE(ret.property(6).toNumber(), -2147483648.);
+    QCOMPARE(ret.property(7).toNumber(), 4294967295.);
+    QCOMPARE(ret.property(8).toNumber(), -4.);
+    QCOMPARE(ret.property(9).toNumber(), 0.1 + 0.2);
+    QCOMPARE(ret.property(10).toNumber(), 7.);
+    QCOMPARE(ret.property(11).toNumber(), -qInf());
+    QCOMPARE(ret.property(12).toNumber(), 1024.);
+    QCOMPARE(ret.property(13).toBool(), true);
+    QCOMPARE(ret.property(14).toString(), QStringLiteral("12"));
+    QCOMPARE(ret.property(15).toNumber(), 5.);
+    QVERIFY(ret.property(16).isNull());
+
+    // constant left-hand side, variable right-hand side
+    ret = eng.evaluate(QStringLiteral(R"(
+        (function() {
+            var n = 3;
+            var s = 4;
+            var k = 28;
+            return [1 << n, 0xff >> s, -1 >>> k];
+        })()
+    )"));
+    QVERIFY(ret.isArray());
+    QCOMPARE(ret.property(0).toNumber(), 8.);
+    QCOMPARE(ret.property(1).toNumber(), 15.);
+    QCOMPARE(ret.property(2).toNumber(), 15.);
+}
+
+void tst_QJSEngine::arraySortStableAndNative()
+{
+    QJSEngine eng;
+    QJSValue ret = eng.evaluate(QStringLiteral(R"(
+        (function() {
+            var rows = [];
+            for (var i = 0; i < 100; ++i)
+                rows.push({ key: (i * 37) % 10, name: 'row' + i, id: i });
+            function ids(array) { return array.map(function(row) { return row.id; }).join(); }
+            function stable(array, ascending) {
+                for (var i = 1; i < array.length; ++i) {
+                    var a = array[i - 1], b = array[i];
+                    if (ascending ? a.key > b.key : a.key < b.key)
+                        return false;
+                    if (a.key === b.key && a.id > b.id)
+                        return false;
+                }
+                return true;
+            }
+            var sorted = [];
+            for (var j = 0; j < 1000; ++j)
+                sorted.push(j);
+            var mixed = [3, 'b', 1, 'a', 2];
+            var calls = 0;
+            var throwing = [3, 1, 2];
+            var threw = false;
+            try {
+                throwing.sort(function(a, b) { ++calls; throw new Error('stop'); });
+            } catch (e) {
+                threw = true;
+            }
+            return [
+                [10, 9, 1, undefined, , 100, 'b', 'a'].sort().join(),
+                [5, 1, 4, 2, 3].sort((a, b) => a - b).join(),
+                [5, 1, 4, 2, 3].sort(function(a, b) { return b - a; }).join(),
+                stable(rows.slice().sort((a, b) => a.key - b.key), true),
+                stable(rows.slice().sort((a, b) => b.key - a.key), false),
+                stable(rows.slice().sort((a, b) => a.key < b.key ? -1 : a.key > b.key ? 1 : 0), true),
+                stable(rows.slice().sort((x, y) => x.key > y.key ? -1 : 1), false),
+                rows.slice().sort((a, b) => a.name < b.name ? -1 : 1)[2].name,
+                ids(rows.slice().sort(function(a, b) { return a.key - b.key || b.id - a.id; })).substring(0, 11),
+                mixed.sort((a, b) => a < b ? -1 : 1).length,
+                ['10', '9', '1'].sort((a, b) => a - b).join(),
+                sorted.sort((a, b) => b - a)[0],
+                sorted.sort((a, b) => a - b)[999],
+                threw && calls === 1 && throwing.join() === '3,1,2',
+                [2, undefined, 1].sort((a, b) => a - b).length,
+                (function() {
+                    var o = Array.prototype.sort.call({0: 3, 1: 1, 100000: 0, length: 2});
+                    return [o[0], o[1], o[100000]].join();
+                })(),
+                (function() {
+                    var o = Array.prototype.sort.call({0: 3, 1: 1, 100000: 0, length: 2},
+                                                      (a, b) => a - b);
+                    return [o[0], o[1], o[100000]].join();
+                })()
+            ];
+        })()
+    )"));
+    QVERIFY2(!ret.isError(), qPrintable(ret.toString()));
+    QVERIFY(ret.isArray());
+    QCOMPARE(ret.property(0).toString(), QStringLiteral("1,10,100,9,a,b,,"));
+    QCOMPARE(ret.property(1).toString(), QStringLiteral("1,2,3,4,5"));
+    QCOMPARE(ret.property(2).toString(), QStringLiteral("5,4,3,2,1"));
+    QVERIFY(ret.property(3).toBool());
+    QVERIFY(ret.property(4).toBool());
+    QVERIFY(ret.property(5).toBool());
+    QVERIFY(ret.property(6).toBool());
+    QCOMPARE(ret.property(7).toString(), QStringLiteral("row10"));
+    QCOMPARE(ret.property(8).toString(), QStringLiteral("90,80,70,60"));
+    QCOMPARE(ret.property(9).toInt(), 5);
+    QCOMPARE(ret.property(10).toString(), QStringLiteral("1,9,10"));
+    QCOMPARE(ret.property(11).toInt(), 999);
+    QCOMPARE(ret.property(12).toInt(), 999);
+    QVERIFY(ret.property(13).toBool());
+    QCOMPARE(ret.property(14).toInt(), 3);
+    QCOMPARE(ret.property(15).toString(), QStringLiteral("1,3,0"));
+    QCOMPARE(ret.property(16).toString(), QStringLiteral("1,3,0"));
+}
+
 void tst_QJSEngine::arraySort()
 {
     // tests that calling Array.sort with a bad sort function doesn't cause issues
@@ -3601,6 +3966,35 @@ void tst_QJSEngine::regexpLastIndex()
     QVERIFY(result.toBool());
 }
 
+void tst_QJSEngine::regexpLiteralPatterns()
+{
+    QJSEngine eng;
+    QJSValue result = eng.evaluate(QStringLiteral(R"(
+        var text = 'a,b,,c, d';
+        var rx = /,/g;
+        rx.test(text);
+        [text.replace(/,/g, ';'), text.split(/,/).join('|'), text.replace(/,/, '[$&$`]'),
+         'aaaa'.replace(/aa/g, 'b'), /, /.exec(text).index, rx.lastIndex,
+         'xAx'.replace(/a/ig, '-'), 'x.y'.split(/./).length, text.split(/,/, 2).join('|')]
+    )"));
+    QVERIFY(!result.isError());
+    QCOMPARE(result.property(0).toString(), QStringLiteral("a;b;;c; d"));
+    QCOMPARE(result.property(1).toString(), QStringLiteral("a|b||c| d"));
+    QCOMPARE(result.property(2).toString(), QStringLiteral("a[,a]b,,c, d"));
+    QCOMPARE(result.property(3).toString(), QStringLiteral("bb"));
+    QCOMPARE(result.property(4).toInt(), 6);
+    QCOMPARE(result.property(5).toInt(), 2);
+    QCOMPARE(result.property(6).toString(), QStringLiteral("x-x"));
+    QCOMPARE(result.property(7).toInt(), 4);
+    QCOMPARE(result.property(8).toString(), QStringLiteral("a|b"));
+
+    // /,/g, /,/, /aa/g and /, / are literal; /a/ig and /./ are not
+    QV4::RegExpCache *cache = eng.handle()->regExpCache;
+    QVERIFY(cache);
+    QCOMPARE(cache->statistics.literalPatterns, 4u);
+    QVERIFY(cache->statistics.literalMatches > 0);
+}
+
 void tst_QJSEngine::indexedAccesses()
 {
     QJSEngine engine;
@@ -5169,6 +5563,55 @@ void tst_QJSEngine::typedArraySet()
     }
 }
 
+void tst_QJSEngine::typedArrayBulkOperations()
+{
+    QJSEngine engine;
+    QJSValue result = engine.evaluate(R"(
+        var f = new Float32Array([3, NaN, 0, -0, -1.5, Infinity, 2]);
+        f.sort();
+        var sorted = Array.prototype.join.call(f, ',') + ':' + (1 / f[1]);
+
+        var i = new Int16Array([5, -3, 300, 5, -3]);
+        i.sort(function(a, b) { return b - a; });
+        var descending = Array.prototype.join.call(i, ',');
+
+        var c = new Uint8ClampedArray(6);
+        c.fill(300, 1, 3).fill(-5, 3).fill(1.5, 5);
+        c.reverse();
+
+        var search = new Uint32Array([1, 4000000000, 7, 7]);
+        [sorted, descending, Array.prototype.join.call(c, ','),
+         search.indexOf(7), search.indexOf(7, 3), search.indexOf(4000000000),
+         search.indexOf(-1), search.indexOf(7.5), search.indexOf('7'),
+         f.includes(NaN), f.indexOf(NaN), f.includes(-0), i.includes(300, 1),
+         f.indexOf(1e300), f.includes(-1e300), f.indexOf(Infinity)]
+    )");
+    QVERIFY(!result.isError());
+    QCOMPARE(result.property(0).toString(), QStringLiteral("-1.5,0,0,2,3,Infinity,NaN:-Infinity"));
+    QCOMPARE(result.property(1).toString(), QStringLiteral("300,5,5,-3,-3"));
+    QCOMPARE(result.property(2).toString(), QStringLiteral("2,0,0,255,255,0"));
+    QCOMPARE(result.property(3).toInt(), 2);
+    QCOMPARE(result.property(4).toInt(), 3);
+    QCOMPARE(result.property(5).toInt(), 1);
+    QCOMPARE(result.property(6).toInt(), -1);
+    QCOMPARE(result.property(7).toInt(), -1);
+    QCOMPARE(result.property(8).toInt(), -1);
+    QCOMPARE(result.property(9).toBool(), true);
+    QCOMPARE(result.property(10).toInt(), -1);
+    QCOMPARE(result.property(11).toBool(), true);
+    QCOMPARE(result.property(12).toBool(), false);
+    QCOMPARE(result.property(13).toInt(), -1);
+    QCOMPARE(result.property(14).toBool(), false);
+    QCOMPARE(result.property(15).toInt(), 5);
+
+    QJSValue error = engine.evaluate("new Int8Array(4).sort(function() { throw new Error('stop'); })");
+    QVERIFY(error.isError());
+    QCOMPARE(error.toString(), QStringLiteral("Error: stop"));
+    error = engine.evaluate("new Int8Array(2).sort(null)");
+    QVERIFY(error.isError());
+    QCOMPARE(error.toString(), QStringLiteral("TypeError: Type error"));
+}
+
 void tst_QJSEngine::dataViewCtor()
 {
     QJSEngine engine;
@@ -5184,6 +5627,37 @@ void tst_QJSEngine::dataViewCtor()
     QCOMPARE(error.toString(), "RangeError: DataView: constructor arguments out of range");
 }
 
+void tst_QJSEngine::literalsCreatedOnFirstUse()
+{
+    QJSEngine engine;
+    QJSValue result = engine.evaluate(R"(
+        function unused() {
+            let a = /never(used)/g;
+            return { x: a, y: 2 };
+        }
+        function used(i) {
+            let matches = /b(\d)/g.exec("ab" + i);
+            let o = { value: matches[1], get twice() { return this.value * 2; } };
+            {
+                let scoped = o.twice;
+                return scoped;
+            }
+        }
+        var sum = 0;
+        for (var i = 0; i < 10; ++i)
+            sum += used(i);
+        sum;
+    )");
+    QVERIFY(!result.isError());
+    QCOMPARE(result.toInt(), 90);
+
+    // Each evaluation of a literal still yields a fresh object
+    result = engine.evaluate("(function() { var r = []; for (var i = 0; i < 2; ++i) r.push(/x/); "
+                             "r[0].lastIndex = 5; return r[0] !== r[1] && r[1].lastIndex === 0; })()");
+    QVERIFY(result.isBool());
+    QVERIFY(result.toBool());
+}
+
 void tst_QJSEngine::uiLanguage()
 {
     {
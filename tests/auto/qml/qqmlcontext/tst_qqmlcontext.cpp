@@ -72,6 +72,7 @@ private slots:
     void outerContextObject();
     void contextObjectHierarchy();
     void destroyContextProperty();
+    void parentContextObjectLookup();
 
 private:
     QQmlEngine engine;
@@ -918,6 +919,51 @@ void tst_qqmlcontext::destroyContextProperty()
     // TODO: Or are we?
 }
 
+void tst_qqmlcontext::parentContextObjectLookup()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import QtQml 2.0\nQtObject { property int value: a; function read() { return a; } }", QUrl());
+    QVERIFY(component.isReady());
+
+    TestObject obj;
+    QQmlContext ctxt(engine.rootContext());
+    ctxt.setContextObject(&obj);
+
+    QScopedPointer<QObject> o(component.create(&ctxt));
+    QVERIFY(!o.isNull());
+    QCOMPARE(o->property("value").toInt(), 10);
+    for (int i = 0; i < 3; ++i) {
+        QVariant result;
+        QMetaObject::invokeMethod(o.data(), "read", Q_RETURN_ARG(QVariant, result));
+        QCOMPARE(result.toInt(), 10);
+    }
+
+    obj.setA(11);
+    QCOMPARE(o->property("value").toInt(), 11);
+
+    // A context property added later shadows the property of the context object
+    ctxt.setContextProperty("a", 12);
+    QCOMPARE(o->property("value").toInt(), 12);
+    {
+        QVariant result;
+        QMetaObject::invokeMethod(o.data(), "read", Q_RETURN_ARG(QVariant, result));
+        QCOMPARE(result.toInt(), 12);
+    }
+
+    // The same code running in a context without a context object
+    QQmlContext ctxt2(engine.rootContext());
+    ctxt2.setContextProperty("a", 13);
+    QScopedPointer<QObject> o2(component.create(&ctxt2));
+    QVERIFY(!o2.isNull());
+    QCOMPARE(o2->property("value").toInt(), 13);
+    {
+        QVariant result;
+        QMetaObject::invokeMethod(o2.data(), "read", Q_RETURN_ARG(QVariant, result));
+        QCOMPARE(result.toInt(), 13);
+    }
+}
+
 QTEST_MAIN(tst_qqmlcontext)
 
 #include "tst_qqmlcontext.moc"
@@ -0,0 +1,15 @@
+import QtQml 2.0
+
+QtObject {
+    property int intValue
+    property bool boolValue
+    property real realValue
+    property string stringValue
+    property url urlValue
+    property date dateValue
+
+    property int urlChanges: 0
+    property int stringChanges: 0
+    onUrlValueChanged: ++urlChanges
+    onStringValueChanged: ++stringChanges
+}
@@ -0,0 +1,38 @@
+import QtQml 2.0
+
+QtObject {
+    id: root
+
+    property int i: 5
+    property real r: 2.5
+    property bool b: true
+    property string s: "foo"
+    property QtObject o: root
+
+    property int captured: root.i * 2
+
+    property QtObject other: QtObject {
+        property string i: "bar"
+    }
+
+    function read(obj) {
+        return [obj.i, obj.r, obj.b, obj.s, obj.o];
+    }
+
+    property bool success: {
+        for (var k = 0; k < 10; ++k) {
+            var values = read(root);
+            if (values[0] !== 5 || values[1] !== 2.5 || values[2] !== true
+                    || values[3] !== "foo" || values[4] !== root) {
+                return false;
+            }
+        }
+
+        // A different type at the same lookup has to fall back to the generic getter
+        var otherValues = read(other);
+        if (otherValues[0] !== "bar" || otherValues[1] !== undefined)
+            return false;
+
+        return read(root)[0] === 5;
+    }
+}
@@ -0,0 +1,33 @@
+import QtQml 2.15
+
+QtObject {
+    id: root
+
+    signal tick(int value, string name)
+
+    property int ticks: 0
+    property int lastValue: -1
+    property string lastName
+    property int argumentCount: -1
+    property int nestedValue: -1
+    property var laterArguments
+
+    onTick: ++ticks
+
+    property QtObject byName: Connections {
+        target: root
+        function onTick(value, name) { root.lastValue = value; root.lastName = name }
+    }
+    property QtObject byArgumentsObject: Connections {
+        target: root
+        function onTick() { root.argumentCount = arguments.length }
+    }
+    property QtObject byClosure: Connections {
+        target: root
+        function onTick(value) { [1].forEach(() => root.nestedValue = value) }
+    }
+
+    function callLaterWithArguments() {
+        Qt.callLater(function() { root.laterArguments = Array.prototype.slice.call(arguments) }, 1, 2, 3)
+    }
+}
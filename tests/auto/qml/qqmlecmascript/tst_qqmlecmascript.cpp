@@ -386,6 +386,9 @@ private slots:
     void proxyIteration();
     void proxyHandlerTraps();
     void gcCrashRegressionTest();
+    void typedQObjectLookups();
+    void unusedSignalArguments();
+    void typedPropertyStorage();
 
 private:
 //    static void propertyVarWeakRefCallback(v8::Persistent<v8::Value> object, void* parameter);
@@ -9401,6 +9404,86 @@ void tst_qqmlecmascript::proxyHandlerTraps()
     QVERIFY(value.isString() && value.toString() == QStringLiteral("SUCCESS"));
 }
 
+void tst_qqmlecmascript::typedQObjectLookups()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("typedQObjectLookups.qml"));
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY2(root != nullptr, qPrintable(component.errorString()));
+    QVERIFY(root->property("success").toBool());
+
+    QCOMPARE(root->property("captured").toInt(), 10);
+    root->setProperty("i", 7);
+    QCOMPARE(root->property("captured").toInt(), 14);
+}
+
+void tst_qqmlecmascript::unusedSignalArguments()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("unusedSignalArguments.qml"));
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY2(root != nullptr, qPrintable(component.errorString()));
+
+    // Handlers that skip the conversion and those that need it must see the same emission
+    QVERIFY(QMetaObject::invokeMethod(root.data(), "tick", Q_ARG(int, 42), Q_ARG(QString, QStringLiteral("answer"))));
+    QCOMPARE(root->property("ticks").toInt(), 1);
+    QCOMPARE(root->property("lastValue").toInt(), 42);
+    QCOMPARE(root->property("lastName").toString(), QStringLiteral("answer"));
+    QCOMPARE(root->property("argumentCount").toInt(), 2);
+    QCOMPARE(root->property("nestedValue").toInt(), 42);
+
+    QVERIFY(QMetaObject::invokeMethod(root.data(), "tick", Q_ARG(int, 7), Q_ARG(QString, QStringLiteral("again"))));
+    QCOMPARE(root->property("ticks").toInt(), 2);
+    QCOMPARE(root->property("lastValue").toInt(), 7);
+    QCOMPARE(root->property("nestedValue").toInt(), 7);
+
+    QVERIFY(QMetaObject::invokeMethod(root.data(), "callLaterWithArguments"));
+    QTRY_COMPARE(root->property("laterArguments").toList().count(), 3);
+}
+
+void tst_qqmlecmascript::typedPropertyStorage()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("typedPropertyStorage.qml"));
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY2(root != nullptr, qPrintable(component.errorString()));
+
+    QCOMPARE(root->property("intValue").toInt(), 0);
+    QCOMPARE(root->property("boolValue").toBool(), false);
+    QCOMPARE(root->property("realValue").toDouble(), 0.0);
+    QVERIFY(root->property("stringValue").toString().isEmpty());
+    QVERIFY(root->property("urlValue").toUrl().isEmpty());
+
+    root->setProperty("intValue", 5);
+    root->setProperty("boolValue", true);
+    root->setProperty("realValue", 2.5);
+    QCOMPARE(root->property("intValue").toInt(), 5);
+    QCOMPARE(root->property("boolValue").toBool(), true);
+    QCOMPARE(root->property("realValue").toDouble(), 2.5);
+
+    // Values stored in place must still be reported as changed, and only when they change
+    const QUrl first(QStringLiteral("http://example.com/first"));
+    const QUrl second(QStringLiteral("http://example.com/second"));
+    root->setProperty("urlValue", first);
+    QCOMPARE(root->property("urlValue").toUrl(), first);
+    root->setProperty("urlValue", second);
+    QCOMPARE(root->property("urlValue").toUrl(), second);
+    root->setProperty("urlValue", second);
+    QCOMPARE(root->property("urlChanges").toInt(), 2);
+
+    root->setProperty("stringValue", QStringLiteral("a"));
+    root->setProperty("stringValue", QStringLiteral("a"));
+    root->setProperty("stringValue", QStringLiteral("b"));
+    QCOMPARE(root->property("stringValue").toString(), QStringLiteral("b"));
+    QCOMPARE(root->property("stringChanges").toInt(), 2);
+
+    const QDate date(2020, 2, 29);
+    root->setProperty("dateValue", date);
+    QCOMPARE(root->property("dateValue").toDate(), date);
+    root->setProperty("dateValue", date.addDays(1));
+    QCOMPARE(root->property("dateValue").toDate(), date.addDays(1));
+}
+
 QTEST_MAIN(tst_qqmlecmascript)
 
 #include "tst_qqmlecmascript.moc"
@@ -48,6 +48,7 @@ private slots:
     void interceptQmldir();
     void singletonVersionResolution();
     void removeDynamicPlugin();
+    void importLookupCache();
     void cleanup();
 };
 
@@ -282,6 +283,41 @@ void tst_QQmlImport::removeDynamicPlugin()
 }
 
 
+void tst_QQmlImport::importLookupCache()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    const QString cacheFile = cacheDir.filePath(QStringLiteral("imports.cache"));
+    qputenv("QML_IMPORT_LOOKUP_CACHE", QFile::encodeName(cacheFile));
+    auto unsetEnv = qScopeGuard([]() { qunsetenv("QML_IMPORT_LOOKUP_CACHE"); });
+
+    auto load = [this]() {
+        QQmlEngine engine;
+        engine.addImportPath(testFile("QTBUG-77102/imports"));
+        QQmlComponent component(&engine, testFileUrl("QTBUG-77102/main.1.0.qml"));
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+        QScopedPointer<QObject> obj(component.create());
+        QVERIFY(!obj.isNull());
+    };
+
+    // The first run stores the lookups, the second one uses them
+    load();
+    QVERIFY(!QTest::currentTestFailed());
+    QVERIFY(QFile::exists(cacheFile));
+    load();
+    QVERIFY(!QTest::currentTestFailed());
+
+    // A corrupt cache is ignored and replaced
+    {
+        QFile file(cacheFile);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("not a cache");
+    }
+    load();
+    QVERIFY(!QTest::currentTestFailed());
+    load();
+}
+
 QTEST_MAIN(tst_QQmlImport)
 
 #include "tst_qqmlimport.moc"
@@ -0,0 +1,9 @@
+import QtQml 2.0
+
+QtObject {
+    property int value: 1
+
+    function outer() {
+        return function inner() { return value * 42; }
+    }
+}
@@ -135,6 +135,7 @@ private slots:
     void autoComponentCreationInGroupProperty();
     void propertyValueSource();
     void requiredProperty();
+    void requiredPropertyRepeatedCreation();
     void requiredPropertyFromCpp_data();
     void requiredPropertyFromCpp();
     void attachedProperties();
@@ -331,6 +332,7 @@ private slots:
     void arrayToContainer();
     void qualifiedScopeInCustomParser();
     void accessNullPointerPropertyCache();
+    void lazyFunctions();
 
 private:
     QQmlEngine engine;
@@ -1735,6 +1737,31 @@ void tst_qqmllanguage::requiredProperty()
     }
 }
 
+void tst_qqmllanguage::requiredPropertyRepeatedCreation()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("requiredProperties.3.qml"));
+    VERIFY_ERRORS(0);
+
+    // The required properties are collected once per component; every instance must still
+    // check them.
+    for (int i = 0; i < 3; ++i) {
+        QScopedPointer<QObject> object(component.createWithInitialProperties({{"i", i}}));
+        QVERIFY2(object, qPrintable(component.errorString()));
+        QCOMPARE(object->property("i").toInt(), i);
+
+        object.reset(component.create());
+        QVERIFY(!object);
+        QVERIFY(component.errorString().contains("Required property i was not initialized"));
+    }
+
+    QQmlComponent missing(&engine, testFileUrl("requiredProperties.7.qml"));
+    for (int i = 0; i < 2; ++i) {
+        QScopedPointer<QObject> object(missing.create());
+        QVERIFY(missing.errorString().contains("Property blub was marked as required but does not exist"));
+    }
+}
+
 class MyClassWithRequiredProperty : public QObject
 {
 public:
@@ -5813,6 +5840,37 @@ void tst_qqmllanguage::accessNullPointerPropertyCache()
     QVERIFY(!obj.isNull());
 }
 
+void tst_qqmllanguage::lazyFunctions()
+{
+    QQmlEngine engine;
+    QQmlComponent c(&engine, testFileUrl("lazyFunctions.qml"));
+    QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+    QScopedPointer<QObject> obj(c.create());
+    QVERIFY(!obj.isNull());
+
+    auto compilationUnit = QQmlComponentPrivate::get(&c)->compilationUnit;
+    QVERIFY(compilationUnit);
+
+    int innerIndex = -1;
+    for (uint i = 0; i < compilationUnit->unitData()->functionTableSize; ++i) {
+        const QV4::CompiledData::Function *function = compilationUnit->unitData()->functionAt(i);
+        if (compilationUnit->stringAt(function->nameIndex) == QLatin1String("inner"))
+            innerIndex = int(i);
+    }
+    QVERIFY(innerIndex != -1);
+
+    // The nested function has not been reached yet.
+    QVERIFY(!compilationUnit->runtimeFunctions.at(innerIndex));
+
+    QVariant closure;
+    QVERIFY(QMetaObject::invokeMethod(obj.data(), "outer", Q_RETURN_ARG(QVariant, closure)));
+    QVERIFY(compilationUnit->runtimeFunctions.at(innerIndex));
+
+    QJSValue inner = closure.value<QJSValue>();
+    QVERIFY(inner.isCallable());
+    QCOMPARE(inner.call().toInt(), 42);
+}
+
 QTEST_MAIN(tst_qqmllanguage)
 
 #include "tst_qqmllanguage.moc"
@@ -0,0 +1,6 @@
+import QtQml 2.0
+
+QtObject {
+    property QtObject first: First {}
+    property QtObject invalid: Invalid {}
+}
@@ -0,0 +1,8 @@
+import QtQml 2.0
+
+QtObject {
+    property QtObject first: First {}
+    property QtObject second: Second {}
+    property QtObject third: Third {}
+    property int sum: first.value + second.value + third.value
+}
@@ -0,0 +1,6 @@
+import QtQml 2.0
+
+QtObject {
+    property QtObject nested: Second {}
+    property int value: nested.value + 1
+}
@@ -40,6 +40,7 @@
 #include <QtQml/private/qqmltypeloader_p.h>
 #include "../../shared/testhttpserver.h"
 #include "../../shared/util.h"
+#include <algorithm>
 
 class tst_QQMLTypeLoader : public QQmlDataTest
 {
@@ -64,6 +65,7 @@ private slots:
     void compositeSingletonCycle();
     void declarativeCppType();
     void circularDependency();
+    void parseAhead();
 };
 
 void tst_QQMLTypeLoader::testLoadComplete()
@@ -601,6 +603,56 @@ void tst_QQMLTypeLoader::circularDependency()
     QCOMPARE(component.status(), QQmlComponent::Null);
 }
 
+void tst_QQMLTypeLoader::parseAhead()
+{
+    if (QThread::idealThreadCount() < 2)
+        QSKIP("Documents are only parsed ahead if there are threads to spare");
+
+#if QT_CONFIG(process)
+    // Run in a child process with the disk cache disabled, as documents loaded
+    // from the disk cache are not parsed ahead.
+    const char *childKey = "QT_TST_QQMLTYPELOADER_PARSE_AHEAD";
+    if (!qEnvironmentVariableIsSet(childKey)) {
+        QProcess child;
+        child.setProgram(QCoreApplication::applicationFilePath());
+        child.setArguments(QStringList(QLatin1String("parseAhead")));
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert(QLatin1String(childKey), QLatin1String("1"));
+        env.insert(QLatin1String("QML_DISABLE_DISK_CACHE"), QLatin1String("1"));
+        child.setProcessEnvironment(env);
+        child.start();
+        QVERIFY(child.waitForFinished());
+        QCOMPARE(child.exitCode(), 0);
+        return;
+    }
+#endif
+
+    {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, testFileUrl("parseAhead/Main.qml"));
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+        QScopedPointer<QObject> object(component.create());
+        QVERIFY(object);
+        QCOMPARE(object->property("sum").toInt(), 6);
+
+        // First, Second and Third are all requested by Main.qml
+        if (qEnvironmentVariableIsSet("QML_DISABLE_DISK_CACHE"))
+            QCOMPARE(QQmlEnginePrivate::get(&engine)->typeLoader.parseAheadCount(), 3);
+    }
+
+    {
+        // Errors in documents parsed ahead are reported for the right file
+        QQmlEngine engine;
+        QQmlComponent component(&engine, testFileUrl("parseAhead/Broken.qml"));
+        QVERIFY(component.isError());
+        const QList<QQmlError> errors = component.errors();
+        const QUrl invalid = testFileUrl("parseAhead/Invalid.qml");
+        QVERIFY2(std::any_of(errors.cbegin(), errors.cend(), [&](const QQmlError &error) {
+            return error.url() == invalid;
+        }), qPrintable(component.errorString()));
+    }
+}
+
 QTEST_MAIN(tst_QQMLTypeLoader)
 
 #include "tst_qqmltypeloader.moc"
@@ -0,0 +1,17 @@
+WorkerScript.onMessage = function(msg) {
+    var sum = 0;
+    for (var i = 0; i < msg.pixels.length; ++i)
+        sum += msg.pixels[i];
+    msg.pixels[0] = 255;
+
+    var rows = msg.rows.map(function(row) { return row.label + ':' + (row.x + row.y); });
+
+    WorkerScript.sendMessage({
+        'sameBuffer': msg.view.buffer === msg.pixels.buffer,
+        'sum': sum,
+        'viewOffset': msg.view.byteOffset,
+        'viewLength': msg.view.length,
+        'rows': rows.join(','),
+        'pixels': msg.pixels
+    }, [ msg.pixels.buffer ]);
+}
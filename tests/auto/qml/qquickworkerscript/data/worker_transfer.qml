@@ -0,0 +1,30 @@
+import QtQuick 2.0
+
+BaseWorker {
+    source: "script_transfer.js"
+
+    property bool sourceDetached: false
+    property var result
+
+    function testTransfer() {
+        var pixels = new Uint8Array(16);
+        for (var i = 0; i < pixels.length; ++i)
+            pixels[i] = i;
+        var view = new Uint16Array(pixels.buffer, 4, 2);
+        var rows = [];
+        for (var j = 0; j < 3; ++j)
+            rows.push({ 'x': j, 'y': j * 2, 'label': 'row' + j });
+        sendMessage({ 'pixels': pixels, 'view': view, 'rows': rows }, [ pixels.buffer ]);
+        sourceDetached = pixels.length === 0 && view.length === 0;
+    }
+
+    function checkResult() {
+        return result.sameBuffer && result.sum === 120
+            && result.viewOffset === 4 && result.viewLength === 2
+            && result.rows === "row0:0,row1:3,row2:6"
+            && result.pixels instanceof Uint8Array
+            && result.pixels.length === 16 && result.pixels[0] === 255;
+    }
+
+    onMessage: result = messageObject
+}
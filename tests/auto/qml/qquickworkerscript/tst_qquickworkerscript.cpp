@@ -53,6 +53,8 @@ private slots:
     void messaging_sendQObjectList();
     void messaging_sendJsObject();
     void messaging_sendExternalObject();
+    void messaging_transferArrayBuffer();
+    void messaging_sharedSource();
     void script_with_pragma();
     void script_included();
     void scriptError_onLoad();
@@ -234,6 +236,53 @@ void tst_QQuickWorkerScript::messaging_sendExternalObject()
     delete obj;
 }
 
+void tst_QQuickWorkerScript::messaging_transferArrayBuffer()
+{
+    QQmlComponent component(&m_engine, testFileUrl("worker_transfer.qml"));
+    QQuickWorkerScript *worker = qobject_cast<QQuickWorkerScript*>(component.create());
+    QVERIFY(worker != nullptr);
+
+    QVERIFY(QMetaObject::invokeMethod(worker, "testTransfer"));
+    QVERIFY(worker->property("sourceDetached").toBool());
+    waitForEchoMessage(worker);
+
+    QVariant result = QVariant::fromValue(false);
+    QVERIFY(QMetaObject::invokeMethod(worker, "checkResult", Qt::DirectConnection,
+            Q_RETURN_ARG(QVariant, result)));
+    QVERIFY(result.toBool());
+
+    qApp->processEvents();
+    delete worker;
+}
+
+void tst_QQuickWorkerScript::messaging_sharedSource()
+{
+    // Both workers run the same script, compiled only once. Use a separate
+    // engine, so that no other test has compiled the script on its worker
+    // thread yet.
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("worker_var.qml"));
+    QScopedPointer<QQuickWorkerScript> first(qobject_cast<QQuickWorkerScript*>(component.create()));
+    QVERIFY(first);
+    QScopedPointer<QQuickWorkerScript> second(qobject_cast<QQuickWorkerScript*>(component.create()));
+    QVERIFY(second);
+
+    for (QQuickWorkerScript *worker : { first.data(), second.data() }) {
+        QVERIFY(QMetaObject::invokeMethod(worker, "testSend", Q_ARG(QVariant, QString("Hello"))));
+        waitForEchoMessage(worker);
+
+        const QMetaObject *mo = worker->metaObject();
+        QCOMPARE(mo->property(mo->indexOfProperty("response")).read(worker).toString(), QString("Hello World"));
+    }
+
+    auto *workerThread = static_cast<QQuickWorkerScriptEngine *>(
+                QQmlEnginePrivate::get(&engine)->workerScriptEngine);
+    QVERIFY(workerThread);
+    QCOMPARE(workerThread->compilationCount(), 1);
+
+    qApp->processEvents();
+}
+
 void tst_QQuickWorkerScript::script_with_pragma()
 {
     QVariant value(100);
@@ -30,6 +30,7 @@
 #include <QQmlEngine>
 #include <QLoggingCategory>
 #include <QQmlComponent>
+#include <QThreadPool>
 
 #include <private/qv4mm_p.h>
 #include <private/qv4qobjectwrapper_p.h>
@@ -48,6 +49,10 @@ private slots:
     void multiWrappedQObjects();
     void accessParentOnDestruction();
     void clearICParent();
+    void pruneDeadTransitions();
+    void incrementalSweep();
+    void concurrentSweep();
+    void concurrentSweepOfWrappers();
 };
 
 void tst_qv4mm::gcStats()
@@ -148,6 +153,134 @@ void tst_qv4mm::clearICParent()
     QFAIL("Garbage collector was not triggered by large amount of InternalClasses");
 }
 
+void tst_qv4mm::pruneDeadTransitions()
+{
+    QV4::ExecutionEngine engine;
+    QV4::Scope scope(engine.rootContext());
+    QV4::Heap::InternalClass *objectClass = engine.internalClasses(QV4::EngineBase::Class_Object);
+    const size_t transitionsBefore = objectClass->transitions.size();
+
+    QV4::ScopedObject object(scope);
+    QV4::ScopedString s(scope);
+    QV4::ScopedValue v(scope, QV4::Value::fromInt32(1));
+    for (uint i = 0; i < 1024; ++i) {
+        s = engine.newIdentifier(QString::fromLatin1("key%1").arg(i));
+        object = engine.newObject();
+        object->insertMember(s, v);
+    }
+
+    // The classes of all but the last object are gone now, and the transitions leading to them
+    // are dropped once a new one is added.
+    engine.memoryManager->runGC();
+    s = engine.newIdentifier(QStringLiteral("last"));
+    object = engine.newObject();
+    object->insertMember(s, v);
+    QVERIFY(objectClass->transitions.size() <= transitionsBefore + 2);
+}
+
+void tst_qv4mm::incrementalSweep()
+{
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    mm->incrementalSweep = true;
+    mm->sweepTimeLimit = 0; // sweep one chunk per slice
+
+    engine.evaluate(QStringLiteral("var garbage = [];"
+                                   "for (var i = 0; i < 100000; ++i)"
+                                   "    garbage.push({ value: i, name: 'item' + i });"
+                                   "garbage = null;"));
+    mm->runGC();
+    QVERIFY(mm->hasPendingSweep());
+    const size_t usedBefore = mm->getUsedMem();
+
+    int slices = 0;
+    while (mm->hasPendingSweep()) {
+        mm->sweepIncrementally();
+        ++slices;
+    }
+    QVERIFY(slices > 1);
+    QVERIFY(mm->getUsedMem() < usedBefore);
+
+    // Objects surviving the collection are still intact, and new ones can be created
+    QJSValue result = engine.evaluate(QStringLiteral("var o = {};"
+                                                     "for (var i = 0; i < 1000; ++i)"
+                                                     "    o['p' + i] = i;"
+                                                     "o.p999 + Object.keys(this).length"));
+    QVERIFY(result.isNumber());
+    QVERIFY(result.toInt() > 999);
+    mm->runGC();
+    mm->incrementalSweep = false;
+    mm->runGC();
+    QVERIFY(!mm->hasPendingSweep());
+}
+
+void tst_qv4mm::concurrentSweep()
+{
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    mm->incrementalSweep = true;
+    mm->concurrentSweep = true;
+
+    for (int round = 0; round < 3; ++round) {
+        engine.evaluate(QStringLiteral("var garbage = [];"
+                                       "for (var i = 0; i < 100000; ++i)"
+                                       "    garbage.push({ value: i, name: 'item' + i, list: [i] });"
+                                       "garbage = null;"
+                                       "var survivors = [];"
+                                       "for (var i = 0; i < 1000; ++i)"
+                                       "    survivors.push({ value: i });"));
+        mm->runGC();
+        QVERIFY(mm->hasPendingSweep());
+
+        // Allocate while the background sweep is running
+        QJSValue result = engine.evaluate(QStringLiteral("var sum = 0;"
+                                                         "for (var i = 0; i < 1000; ++i)"
+                                                         "    sum += survivors[i].value + [i, i].length;"
+                                                         "sum"));
+        QCOMPARE(result.toInt(), 999 * 1000 / 2 + 2000);
+    }
+
+    const size_t usedBefore = mm->getUsedMem();
+    mm->sweepIncrementally();
+    while (mm->hasPendingSweep())
+        mm->sweepIncrementally();
+    QVERIFY(mm->getUsedMem() <= usedBefore);
+    QCOMPARE(mm->blockAllocator.chunksInBackgroundSweep, size_t(0));
+}
+
+void tst_qv4mm::concurrentSweepOfWrappers()
+{
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    mm->incrementalSweep = true;
+    mm->concurrentSweep = true;
+
+    // QObject wrappers need to be destroyed on the main thread. Their chunks should still be
+    // swept in the background.
+    const int count = 20000;
+    int deleted = 0;
+    for (int i = 0; i < count; ++i) {
+        QObject *object = new QObject;
+        QObject::connect(object, &QObject::destroyed, [&deleted]() { ++deleted; });
+        engine.newQObject(object);
+    }
+
+    mm->runGC();
+    QVERIFY(mm->hasPendingSweep());
+    const size_t chunks = mm->blockAllocator.chunksInBackgroundSweep;
+    QVERIFY(chunks > 0);
+    const size_t sweptBefore = mm->blockAllocator.chunksSweptInBackground;
+
+    // Let the background thread get through all of them before taking them back
+    QThreadPool::globalInstance()->waitForDone();
+    while (mm->hasPendingSweep())
+        mm->sweepIncrementally();
+    QCOMPARE(mm->blockAllocator.chunksSweptInBackground - sweptBefore, chunks);
+
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    QCOMPARE(deleted, count);
+}
+
 QTEST_MAIN(tst_qv4mm)
 
 #include "tst_qv4mm.moc"